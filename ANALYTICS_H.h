@@ -0,0 +1,347 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "GAME_ENGINE_H.h"
+
+using namespace std;
+
+// --- TURN RECORDS ---
+// One row per choice a player makes: where they were, what they picked,
+// where it took them and how the wolf came out of it. A choice that only
+// dismisses an active event moves nothing and is not logged.
+enum AnalyticsColumn {
+    A_SESSION, A_TURN, A_NODE, A_CHOICE, A_TO, A_HEALTH, A_HUNGER, A_ENERGY, A_ITEMS, A_EVENT, A_ENDING,
+    A_COLUMNS
+};
+
+struct TurnRecord {
+    int64_t col[A_COLUMNS];
+};
+
+// Event column: 0 = none, 1.. = known events, 255 = anything else.
+inline int eventCode(const GameEngine& g) {
+    if (!g.eventActive) return 0;
+    const GameEvent* known[] = {&SNOWSTORM, &HUNTER_SHOT, &PREY_CAUGHT, &LAST_STRETCH};
+    for (int i = 0; i < 4; i++)
+        if (g.activeEvent.description == known[i]->description) return i + 1;
+    return 255;
+}
+
+// After g.makeChoice(choice) moved the session on from `from`.
+inline TurnRecord turnRecord(uint64_t session, long long turn, const GameEngine& g, const StoryNode* from, int choice) {
+    TurnRecord r;
+    int items = 0;
+    for (const Item* i = g.inventoryHead.get(); i; i = i->next.get()) items++;
+    r.col[A_SESSION] = (int64_t)session;
+    r.col[A_TURN] = turn;
+    r.col[A_NODE] = from->id;
+    r.col[A_CHOICE] = choice;
+    r.col[A_TO] = g.current->id;
+    r.col[A_HEALTH] = g.player.health;
+    r.col[A_HUNGER] = g.player.hunger;
+    r.col[A_ENERGY] = g.player.energy;
+    r.col[A_ITEMS] = items;
+    r.col[A_EVENT] = eventCode(g);
+    r.col[A_ENDING] = g.current->isEnding ? g.current->id : 0;
+    return r;
+}
+
+// --- FILE FORMAT ---
+// "WOLFCOL1", u32 column count, then blocks of up to 64K rows:
+//   u32 rows, u32 byte length per column, then each column's bytes.
+// A column is its values delta-coded against the previous row, zigzagged
+// and written as LEB128 varints: slowly changing columns (turn, stats,
+// session within a batch) mostly take one byte per row. There is no
+// general-purpose compression on top. The lengths let a reader skip every
+// column it doesn't need.
+const char ANALYTICS_MAGIC[9] = "WOLFCOL1";
+const int ANALYTICS_BLOCK_ROWS = 65536;
+
+inline void putVarint(vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) { out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+    out.push_back((uint8_t)v);
+}
+
+inline void encodeColumn(const vector<TurnRecord>& rows, int c, vector<uint8_t>& out) {
+    int64_t prev = 0;
+    for (const TurnRecord& r : rows) {
+        int64_t d = (int64_t)((uint64_t)r.col[c] - (uint64_t)prev);
+        prev = r.col[c];
+        putVarint(out, ((uint64_t)d << 1) ^ (uint64_t)(d >> 63));
+    }
+}
+
+// Decodes n values into out; returns false on a malformed column.
+inline bool decodeColumn(const uint8_t* p, const uint8_t* end, int n, int64_t* out) {
+    int64_t prev = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t v = 0;
+        int shift = 0;
+        while (true) {
+            if (p >= end || shift > 63) return false;
+            uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+            shift += 7;
+        }
+        prev += (int64_t)((v >> 1) ^ (0 - (v & 1)));
+        out[i] = prev;
+    }
+    return true;
+}
+
+// --- WRITER ---
+// record() appends to the calling thread's own lane under that lane's lock,
+// which only close() ever contends. Every ANALYTICS_LANE_ROWS rows a lane
+// hands its rows to the open block under the writer's lock, so threads
+// meet once per batch, not once per turn. Full blocks go to a background
+// thread that encodes and writes them, so no turn waits on encoding or the
+// disk; at most ANALYTICS_QUEUED_BLOCKS wait for it. Past that, the thread
+// completing a block waits for room (stalls), or with dropWhenBehind drops
+// the block (droppedRows). After a failed write nothing more is written and
+// later rows are dropped. rows and bytes count what reached the file.
+const int ANALYTICS_LANE_ROWS = 1024;
+const int ANALYTICS_QUEUED_BLOCKS = 8;
+
+struct AnalyticsWriter {
+    atomic<long long> rows{0};
+    atomic<long long> bytes{0};
+    atomic<long long> droppedRows{0};
+    atomic<long long> stalls{0};
+    atomic<bool> failed{false};
+    bool dropWhenBehind = false;   // set before the first record()
+
+    ~AnalyticsWriter() { close(); }
+
+    bool open(const string& path) {
+        file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        uint32_t columns = A_COLUMNS;
+        if (fwrite(ANALYTICS_MAGIC, 1, 8, file) != 8 || fwrite(&columns, 4, 1, file) != 1) {
+            fclose(file);
+            file = nullptr;
+            return false;
+        }
+        bytes = 12;
+        filling.reserve(ANALYTICS_BLOCK_ROWS);
+        worker = thread([this] { run(); });
+        return true;
+    }
+
+    void record(const TurnRecord& r) {
+        Lane& lane = myLane();
+        lock_guard<mutex> own(lane.lock);
+        lane.rows.push_back(r);
+        if ((int)lane.rows.size() >= ANALYTICS_LANE_ROWS) {
+            hand(lane.rows);
+            lane.rows.clear();
+        }
+    }
+
+    // Flushes every lane and the last partial block, waits for the writer
+    // to finish. False if anything failed to reach the file.
+    bool close() {
+        if (!file) return !failed;
+        vector<Lane*> all;
+        {
+            lock_guard<mutex> guard(lock);
+            for (auto& kv : lanes) all.push_back(kv.second.get());
+        }
+        for (Lane* lane : all) {
+            lock_guard<mutex> own(lane->lock);
+            hand(lane->rows);
+            lane->rows.clear();
+        }
+        {
+            lock_guard<mutex> guard(lock);
+            if (!filling.empty()) full.push_back(move(filling));
+            filling.clear();
+            closing = true;
+        }
+        ready.notify_one();
+        worker.join();
+        if (fclose(file) != 0) failed = true;
+        file = nullptr;
+        return !failed;
+    }
+
+private:
+    struct Lane {
+        mutex lock;
+        vector<TurnRecord> rows;
+    };
+
+    FILE* file = nullptr;
+    const uint64_t serial = newSerial();
+    mutex lock;
+    condition_variable ready, room;
+    unordered_map<thread::id, unique_ptr<Lane>> lanes;
+    vector<TurnRecord> filling;
+    deque<vector<TurnRecord>> full;
+    bool closing = false;
+    thread worker;
+
+    static uint64_t newSerial() {
+        static atomic<uint64_t> next{1};
+        return next++;
+    }
+
+    // One lookup per thread per writer; after that a thread-local compare.
+    Lane& myLane() {
+        static thread_local uint64_t cachedSerial = 0;
+        static thread_local Lane* cached = nullptr;
+        if (cachedSerial != serial) {
+            lock_guard<mutex> guard(lock);
+            unique_ptr<Lane>& lane = lanes[this_thread::get_id()];
+            if (!lane) lane.reset(new Lane);
+            cached = lane.get();
+            cachedSerial = serial;
+        }
+        return *cached;
+    }
+
+    // Moves rows into the open block, queueing each block that fills.
+    void hand(const vector<TurnRecord>& batch) {
+        unique_lock<mutex> lk(lock);
+        for (size_t at = 0; at < batch.size();) {
+            size_t n = min(batch.size() - at, (size_t)ANALYTICS_BLOCK_ROWS - filling.size());
+            filling.insert(filling.end(), batch.begin() + at, batch.begin() + at + n);
+            at += n;
+            if ((int)filling.size() < ANALYTICS_BLOCK_ROWS) continue;
+            if ((int)full.size() >= ANALYTICS_QUEUED_BLOCKS && !failed) {
+                if (dropWhenBehind) {
+                    droppedRows += filling.size();
+                    filling.clear();
+                    continue;
+                }
+                stalls++;
+                room.wait(lk, [this] { return (int)full.size() < ANALYTICS_QUEUED_BLOCKS || failed; });
+            }
+            full.push_back(move(filling));
+            filling = vector<TurnRecord>();
+            filling.reserve(ANALYTICS_BLOCK_ROWS);
+            ready.notify_one();
+        }
+    }
+
+    void run() {
+        vector<uint8_t> columns[A_COLUMNS];
+        while (true) {
+            vector<TurnRecord> batch;
+            {
+                unique_lock<mutex> lk(lock);
+                ready.wait(lk, [this] { return closing || !full.empty(); });
+                if (full.empty()) return;
+                batch = move(full.front());
+                full.pop_front();
+            }
+            room.notify_all();
+            if (failed) { droppedRows += batch.size(); continue; }
+            uint32_t header[1 + A_COLUMNS];
+            header[0] = (uint32_t)batch.size();
+            for (int c = 0; c < A_COLUMNS; c++) {
+                columns[c].clear();
+                encodeColumn(batch, c, columns[c]);
+                header[1 + c] = (uint32_t)columns[c].size();
+            }
+            bool ok = fwrite(header, 4, 1 + A_COLUMNS, file) == 1 + A_COLUMNS;
+            for (int c = 0; c < A_COLUMNS && ok; c++)
+                ok = fwrite(columns[c].data(), 1, columns[c].size(), file) == columns[c].size();
+            if (!ok) {   // the block may be torn; the reader keeps the ones before it
+                failed = true;
+                droppedRows += batch.size();
+                room.notify_all();
+                continue;
+            }
+            bytes += 4 * (1 + A_COLUMNS);
+            for (int c = 0; c < A_COLUMNS; c++) bytes += columns[c].size();
+            rows += batch.size();
+        }
+    }
+};
+
+// --- READER ---
+// Maps the file and indexes its blocks; columns are decoded on demand.
+// A writer that died mid-block leaves a torn tail: the complete blocks
+// before it are kept and its length is reported in tornBytes.
+struct AnalyticsBlock {
+    int rows;
+    const uint8_t* column[A_COLUMNS];
+    const uint8_t* columnEnd[A_COLUMNS];
+};
+
+struct AnalyticsReader {
+    vector<AnalyticsBlock> blocks;
+    long long rows = 0;
+    size_t tornBytes = 0;
+
+    ~AnalyticsReader() {
+        if (data) munmap((void*)data, size);
+    }
+
+    bool open(const string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < 12) { ::close(fd); return false; }
+        size = st.st_size;
+        void* m = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (m == MAP_FAILED) return false;
+        data = (const uint8_t*)m;
+        madvise(m, size, MADV_SEQUENTIAL);
+
+        uint32_t columns;
+        memcpy(&columns, data + 8, 4);
+        if (memcmp(data, ANALYTICS_MAGIC, 8) != 0 || columns != A_COLUMNS) return false;
+        size_t pos = 12;
+        while (pos + 4 * (1 + A_COLUMNS) <= size) {
+            uint32_t header[1 + A_COLUMNS];
+            memcpy(header, data + pos, sizeof header);
+            size_t at = pos + sizeof header;
+            AnalyticsBlock b;
+            b.rows = (int)header[0];
+            bool whole = true;
+            for (int c = 0; c < A_COLUMNS && whole; c++) {
+                if (header[1 + c] > size - at) { whole = false; break; }
+                b.column[c] = data + at;
+                at += header[1 + c];
+                b.columnEnd[c] = data + at;
+            }
+            if (!whole) break;
+            blocks.push_back(b);
+            rows += b.rows;
+            pos = at;
+        }
+        tornBytes = size - pos;
+        return true;
+    }
+
+    bool column(const AnalyticsBlock& b, AnalyticsColumn c, vector<int64_t>& out) const {
+        out.resize(b.rows);
+        return decodeColumn(b.column[c], b.columnEnd[c], b.rows, out.data());
+    }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+#endif
@@ -0,0 +1,214 @@
+// Per-scene analytics over a turn log (ANALYTICS_H.h): how often each choice
+// is picked, and where players quit without reaching an ending.
+// Build: g++ -O2 -std=c++17 -pthread Analyze.cpp -o analyze
+// Run:   ./analyze turns.wcl [threads] [rows shown]
+//        ./analyze --simulate turns.wcl [sessions] [threads]   (writes a synthetic log)
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "GAME_ENGINE_H.h"
+#include "ANALYTICS_H.h"
+#include "SOLVER_H.h"
+
+using namespace std;
+
+// --- SIMULATION ---
+// Players with a per-scene taste for one side, a 2% chance of quitting each
+// turn and 12% in every seventh scene, so the report has something to find.
+int simulate(const string& path, long long sessions, int threads) {
+    AnalyticsWriter log;
+    if (!log.open(path)) { cerr << "cannot write " << path << "\n"; return 1; }
+    atomic<long long> next{1};
+    auto t0 = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            for (long long id; (id = next++) <= sessions;) {
+                GameEngine g;
+                g.start(STORY);
+                g.seed(zobristMix((uint64_t)id));
+                for (long long turn = 0; !g.current->isEnding;) {
+                    if (isDeath(g.player.health, g.player.hunger, g.player.energy)) break;
+                    if (!g.current->hasChoices()) break;
+                    int quit = g.current->id % 7 == 0 ? 12 : 2;
+                    if (g.rollPercent() < quit) break;
+                    int choice = g.rollPercent() < g.current->id * 37 % 101 ? 1 : 2;
+                    const StoryNode* from = g.current;
+                    bool dismissal = g.eventActive;
+                    g.makeChoice(choice);
+                    if (!dismissal) log.record(turnRecord((uint64_t)id, turn++, g, from, choice));   // as CommandSession
+                }
+            }
+        });
+    }
+    for (thread& w : workers) w.join();
+    bool written = log.close();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    cout << sessions << " sessions, " << log.rows << " rows, " << log.bytes << " bytes ("
+         << fixed << setprecision(2) << (log.rows ? (double)log.bytes / log.rows : 0) << " B/row) in "
+         << setprecision(2) << secs << " s, " << log.stalls << " stalls, " << log.droppedRows << " rows dropped\n";
+    if (!written) { cerr << "write to " << path << " failed\n"; return 1; }
+    return 0;
+}
+
+// --- AGGREGATION ---
+// Each thread takes whole blocks and decodes only the columns it needs.
+// A session's outcome is its highest-numbered turn, kept in a flat
+// open-addressing table per thread and merged at the end. A session's turns
+// mostly sit together in a block, so only the last row of each run is looked up.
+// Session ids are handed out in sequence, so the table is indexed by the id
+// itself: neighbouring sessions share cache lines instead of scattering.
+enum SessionEnd { QUIT, DIED, ENDED };
+
+struct LastTurn {
+    uint64_t session;   // 0 = empty slot
+    int64_t turn;
+    int32_t to;
+    int32_t outcome;
+};
+
+struct LastTurns {
+    vector<LastTurn> slots;
+    size_t used = 0;
+
+    LastTurns() : slots(1 << 16) {}
+
+    void offer(const LastTurn& t) {
+        if (2 * (used + 1) > slots.size()) grow();
+        size_t mask = slots.size() - 1;
+        for (size_t i = t.session & mask;; i = (i + 1) & mask) {
+            LastTurn& s = slots[i];
+            if (s.session == 0) { s = t; used++; return; }
+            if (s.session == t.session) { if (t.turn > s.turn) s = t; return; }
+        }
+    }
+
+    void grow() {
+        vector<LastTurn> old(slots.size() * 2);
+        old.swap(slots);
+        used = 0;
+        for (const LastTurn& t : old) if (t.session) offer(t);
+    }
+};
+
+struct NodeStats {
+    long long picked[2] = {0, 0};
+    long long reached = 0, quit = 0, died = 0, ended = 0;
+};
+
+struct Tally {
+    vector<NodeStats> nodes;
+    LastTurns last;
+    bool ok = true;
+
+    NodeStats& at(int64_t id) {
+        if (id < 0) id = 0;
+        if ((size_t)id >= nodes.size()) nodes.resize(id + 1);
+        return nodes[id];
+    }
+};
+
+void tallyBlock(const AnalyticsReader& log, const AnalyticsBlock& b, Tally& t) {
+    static thread_local vector<int64_t> col[A_COLUMNS];
+    const AnalyticsColumn used[] = {A_SESSION, A_TURN, A_NODE, A_CHOICE, A_TO, A_HEALTH, A_HUNGER, A_ENERGY, A_ENDING};
+    for (AnalyticsColumn c : used)
+        if (!log.column(b, c, col[c])) { t.ok = false; return; }
+    for (int r = 0; r < b.rows; r++) {
+        NodeStats& from = t.at(col[A_NODE][r]);
+        int choice = (int)col[A_CHOICE][r];
+        if (choice == 1 || choice == 2) from.picked[choice - 1]++;
+        if (col[A_TURN][r] == 0) from.reached++;
+        t.at(col[A_TO][r]).reached++;
+        if (r + 1 < b.rows && col[A_SESSION][r + 1] == col[A_SESSION][r]) continue;   // not the end of a run
+        int outcome = col[A_ENDING][r] ? ENDED
+                    : isDeath((int)col[A_HEALTH][r], (int)col[A_HUNGER][r], (int)col[A_ENERGY][r]) ? DIED : QUIT;
+        t.last.offer({(uint64_t)col[A_SESSION][r], col[A_TURN][r], (int32_t)col[A_TO][r], outcome});
+    }
+}
+
+int analyze(const string& path, int threads, int shown) {
+    auto t0 = chrono::steady_clock::now();
+    AnalyticsReader log;
+    if (!log.open(path)) { cerr << "cannot read " << path << "\n"; return 1; }
+    if (log.tornBytes) cerr << path << ": ignoring a truncated last block (" << log.tornBytes << " bytes)\n";
+
+    vector<Tally> tallies(threads);
+    atomic<size_t> nextBlock{0};
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            for (size_t i; (i = nextBlock++) < log.blocks.size();) tallyBlock(log, log.blocks[i], tallies[t]);
+        });
+    }
+    for (thread& w : workers) w.join();
+
+    Tally& all = tallies[0];
+    for (int t = 1; t < threads; t++) {
+        for (size_t n = 0; n < tallies[t].nodes.size(); n++) {
+            NodeStats& a = all.at(n);
+            const NodeStats& b = tallies[t].nodes[n];
+            a.picked[0] += b.picked[0]; a.picked[1] += b.picked[1]; a.reached += b.reached;
+        }
+        for (const LastTurn& s : tallies[t].last.slots) if (s.session) all.last.offer(s);
+        all.ok = all.ok && tallies[t].ok;
+    }
+    if (!all.ok) { cerr << path << ": corrupt column data\n"; return 1; }
+    long long quitters = 0;
+    for (const LastTurn& s : all.last.slots) {
+        if (!s.session) continue;
+        NodeStats& n = all.at(s.to);
+        if (s.outcome == ENDED) n.ended++;
+        else if (s.outcome == DIED) n.died++;
+        else { n.quit++; quitters++; }
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    cout << log.rows << " rows, " << log.blocks.size() << " blocks, " << all.last.used << " sessions ("
+         << quitters << " quit) in " << fixed << setprecision(2) << secs << " s\n\n";
+
+    vector<int> order;
+    for (size_t n = 0; n < all.nodes.size(); n++) if (all.nodes[n].reached) order.push_back((int)n);
+    auto dropOff = [&](int n) { return (double)all.nodes[n].quit / all.nodes[n].reached; };
+    sort(order.begin(), order.end(), [&](int a, int b) { return dropOff(a) > dropOff(b); });
+    cout << "scene   reached      quit  drop-off      died     ended    A%     B%\n";
+    for (int i = 0; i < (int)order.size() && i < shown; i++) {
+        const NodeStats& s = all.nodes[order[i]];
+        long long picks = s.picked[0] + s.picked[1];
+        cout << setw(5) << order[i] << setw(10) << s.reached << setw(10) << s.quit
+             << setw(9) << setprecision(1) << 100 * dropOff(order[i]) << "%"
+             << setw(10) << s.died << setw(10) << s.ended;
+        if (picks) cout << setw(6) << 100.0 * s.picked[0] / picks << setw(7) << 100.0 * s.picked[1] / picks;
+        cout << "\n";
+    }
+
+    cout << "\nnever picked:";
+    int never = 0;
+    for (size_t n = 0; n < all.nodes.size(); n++) {
+        const NodeStats& s = all.nodes[n];
+        if (s.picked[0] + s.picked[1] == 0) continue;
+        const StoryNode* node = STORY.find((int)n);
+        if (!node) continue;
+        if (node->left >= 0 && !s.picked[0]) { cout << " " << n << "/A"; never++; }
+        if (node->right >= 0 && !s.picked[1]) { cout << " " << n << "/B"; never++; }
+    }
+    cout << (never ? "\n" : " none\n");
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int cores = max(1u, thread::hardware_concurrency());
+    if (argc > 2 && strcmp(argv[1], "--simulate") == 0)
+        return simulate(argv[2], argc > 3 ? atoll(argv[3]) : 1000000, argc > 4 ? atoi(argv[4]) : cores);
+    if (argc < 2) {
+        cerr << "usage: analyze turns.wcl [threads] [rows]   |   analyze --simulate turns.wcl [sessions] [threads]\n";
+        return 1;
+    }
+    return analyze(argv[1], argc > 2 ? max(1, atoi(argv[2])) : cores, argc > 3 ? atoi(argv[3]) : 20);
+}
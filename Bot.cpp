@@ -0,0 +1,213 @@
+// Line-command front end for bots: reads pipelined commands from stdin,
+// answers each read's worth of commands with one write.
+// Build: g++ -O2 -std=c++20 Bot.cpp -o bot
+// Run:   ./bot [--scripts] [--metrics port] < commands.txt   or   ./bot --bench [commands]
+//        ./bot --check   runs undo/redo/jump/branch and the story scripts through the command parser
+// --scripts plays with the story scripts (SCRIPTS_H.h) attached.
+// Metrics: Prometheus text on http://127.0.0.1:port/ while serving;
+// --bench writes them to bot_metrics.prom.
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "GAME_ENGINE_H.h"
+#include "COMMANDS_H.h"
+#include "METRICS_H.h"
+#include "SCRIPTS_H.h"
+
+using namespace std;
+
+static bool writeAll(const string& s) {
+    size_t done = 0;
+    while (done < s.size()) {
+        ssize_t n = write(1, s.data() + done, s.size() - done);
+        if (n <= 0) return false;
+        done += n;
+    }
+    return true;
+}
+
+// Feeds a canned command mix in 64 KB chunks and reports throughput.
+static int bench(long long count) {
+    GameEngine game;
+    game.init();
+    game.seed(1);
+    CommandSession session(game);
+
+    const char* mix[] = {"choice 1\n", "status\n", "2\n", "inventory\n", "use Medical Herbs\n", "undo\n", "undo\n", "bogus\n"};
+    string script;
+    for (long long i = 0; i < count; i++) script += mix[i % 8];
+
+    auto t0 = chrono::steady_clock::now();
+    size_t replyBytes = 0;
+    for (size_t at = 0; at < script.size(); at += 65536) {
+        session.feed(script.data() + at, min<size_t>(65536, script.size() - at));
+        replyBytes += session.out.size();
+        session.out.clear();
+    }
+    session.finish();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    cout << session.commands << " commands (" << session.errors << " errors) in " << secs * 1000 << " ms, "
+         << (long long)(session.commands / secs) << " commands/s, " << replyBytes << " reply bytes\n";
+    return metricsWriteFile("bot_metrics.prom") ? 0 : 1;
+}
+
+// A session with the story scripts attached, remembering whether the
+// hunters of scene 12 have struck.
+struct ScriptedGame {
+    GameEngine game;
+    ScriptRunner run;
+    CommandSession session;
+    bool ambushed = false;
+
+    ScriptedGame() : run(game), session(game) {
+        game.init();
+        game.seed(1);
+        addStoryScripts(run);
+    }
+
+    void send(const char* line) {
+        session.out.clear();
+        session.feed(line, strlen(line));
+        if (game.eventActive && game.activeEvent.description.rfind("Hunters'", 0) == 0) ambushed = true;
+    }
+
+    // 1 -> 2 -> 4 -> 9 -> 12, clearing events on the way but not the one
+    // (if any) raised on arriving, so no turn has passed in scene 12 yet.
+    void toScene12() {
+        for (const char* c : {"1\n", "1\n", "2\n", "1\n"}) {
+            while (game.eventActive) send("wait\n");
+            send(c);
+        }
+    }
+
+    void wait(int turns) {
+        for (int i = 0; i < turns; i++) send("wait\n");
+    }
+};
+
+template <class Expect>
+static void checkScripts(Expect& check) {
+    {
+        ScriptedGame s;
+        s.toScene12();
+        check(s.game.current->id == 12 && s.run.running() == 2 && s.run.filedFor(W_LEAVE, 12) == 1,
+              "entering scene 12 starts the hunters");
+        s.wait(8);
+        check(s.ambushed && s.game.current->id == 12, "waiting in scene 12 ends in the hunters' ambush");
+        check(s.run.running() == 1 && s.run.filedFor(W_LEAVE, 12) == 0 && s.run.filedFor(W_TURNS) == 0,
+              "the ambush leaves nothing filed behind");
+    }
+    {
+        ScriptedGame s;
+        s.toScene12();
+        while (s.game.eventActive) s.send("wait\n");
+        s.send("1\n");
+        check(s.game.current->id == 15 && s.run.filedFor(W_TURNS) == 0, "leaving 12 unfiles the hunters' turn wait");
+        s.wait(8);
+        check(!s.ambushed && s.run.running() == 1, "leaving 12 cancels the ambush");
+    }
+    {
+        ScriptedGame s;
+        s.toScene12();
+        s.send("undo\n");
+        check(s.game.current->id == 9 && s.run.running() == 1 && s.run.filedFor(W_LEAVE, 12) == 0 &&
+              s.run.filedFor(W_TURNS) == 0, "undo out of 12 cancels the hunters");
+        s.send("redo\n");
+        check(s.game.current->id == 12 && s.run.running() == 2, "redo back into 12 starts the hunters over");
+        s.wait(8);
+        check(s.ambushed, "and they strike again");
+        s.send("jump 3\n");
+        s.ambushed = false;
+        s.wait(8);
+        check(s.game.current->id == 9 && !s.ambushed, "no ambush after jumping back out of 12");
+    }
+}
+
+// Time travel through the commands, checked against the engine's state hash.
+static int check() {
+    GameEngine game;
+    game.init();
+    game.seed(1);
+    CommandSession session(game);
+    int failures = 0;
+    auto send = [&](const string& line) {
+        session.out.clear();
+        session.feed(line.data(), line.size());
+        return session.out;
+    };
+    auto expect = [&](bool ok, const string& what) {
+        cout << (ok ? "ok    " : "FAIL  ") << what << endl;
+        if (!ok) failures++;
+    };
+    // A turn, plus any turns that only clear the event it raised.
+    auto step = [&](const char* choice) {
+        send(choice);
+        while (game.eventActive) send(choice);
+        return game.stateHash();
+    };
+
+    uint64_t start = game.stateHash();
+    expect(send("redo\n").rfind("ERR", 0) == 0, "nothing to redo at the start");
+    uint64_t a1 = step("1\n"), a2 = step("1\n"), a3 = step("1\n");
+
+    send("undo\n");
+    expect(game.stateHash() == a2, "undo goes back one turn");
+    send("undo\n");
+    expect(game.stateHash() == a1, "undo again goes back two");
+    send("redo\n");
+    expect(game.stateHash() == a2, "redo goes forward one");
+    send("redo\n");
+    expect(game.stateHash() == a3 && game.history.turn() == 3, "redo again is back at turn 3");
+    expect(send("redo\n").rfind("ERR", 0) == 0, "nothing to redo at the newest turn");
+
+    send("jump 0\n");
+    expect(game.stateHash() == start && game.history.turn() == 0, "jump 0 is the opening scene");
+    send("redo\nredo\nredo\n");
+    expect(game.stateHash() == a3, "redo walks back down the branch jumped from");
+    expect(send("jump 9\n").rfind("ERR", 0) == 0 && game.stateHash() == a3, "jump past the current turn is refused");
+    expect(send("jump x\n").rfind("ERR", 0) == 0, "jump needs a number");
+
+    send("undo\n");
+    uint64_t b3 = step("2\n");
+    string reply = send("branch 1\n");
+    expect(game.stateHash() == a3 && reply.rfind("OK branch 1 of 2", 0) == 0, "branch 1 is the path taken first: " + reply.substr(0, reply.size() - 1));
+    send("branch 2\n");
+    expect(game.stateHash() == b3, "branch 2 is the path taken after the undo");
+    expect(send("branch 3\n").rfind("ERR", 0) == 0 && game.stateHash() == b3, "there is no third branch");
+    send("undo\n");
+    expect(game.stateHash() == a2, "both branches undo to the same turn");
+
+    checkScripts(expect);
+    cout << (failures ? to_string(failures) + " failed" : string("all checks passed")) << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) return bench(argc > 2 ? atoll(argv[2]) : 1000000);
+    if (argc > 1 && strcmp(argv[1], "--check") == 0) return check();
+
+    bool scripts = argc > 1 && strcmp(argv[1], "--scripts") == 0;
+    if (scripts) argc--, argv++;
+    MetricsServer metrics;
+    if (argc > 2 && strcmp(argv[1], "--metrics") == 0 && !metrics.start(atoi(argv[2])))
+        cerr << "metrics: could not listen on port " << argv[2] << "\n";
+
+    GameEngine game;
+    game.init();
+    ScriptRunner run(game);
+    if (scripts) addStoryScripts(run);
+    CommandSession session(game);
+    char buf[65536];
+    while (true) {
+        ssize_t n = read(0, buf, sizeof buf);
+        if (n <= 0) break;
+        session.feed(buf, n);
+        if (!writeAll(session.out)) return 1;
+        session.out.clear();
+    }
+    session.finish();
+    return writeAll(session.out) ? 0 : 1;
+}
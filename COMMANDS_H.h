@@ -0,0 +1,206 @@
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <charconv>
+#include <cstring>
+#include "GAME_ENGINE_H.h"
+#include "ANALYTICS_H.h"
+
+using namespace std;
+
+// --- TEXT COMMANDS ---
+// One command per line:
+//   choice 1|2   (or just 1 / 2)
+//   wait         (a turn in place: weathers an event, or lingers in the scene)
+//   undo
+//   redo
+//   jump <turn>  (back to that turn of this branch, 0 = the opening scene)
+//   branch <n>   (the n'th path taken from the previous turn, from 1)
+//   use <item name>
+//   inventory
+//   save         (to savePath, same format as autoSave)
+//   status
+// Every command gets exactly one reply line, "OK ..." or "ERR ...", in order.
+// Input is read in whatever chunks arrive; lines are tokenized in place and
+// only a line split across two reads is copied. Replies for a whole chunk
+// are collected in `out` so the caller can write them back in one go.
+// With `analytics` set, every choice that moves is also logged as a TurnRecord.
+struct CommandSession {
+    static const size_t MAX_LINE = 4096;
+
+    GameEngine& game;
+    string out;              // replies not yet sent
+    string partial;          // unfinished line from the previous chunk
+    bool skipping = false;   // inside a line that was already too long
+    long long commands = 0;
+    long long errors = 0;
+    AnalyticsWriter* analytics = nullptr;
+    uint64_t sessionId = 0;
+    long long turns = 0;     // choices made, numbers the analytics rows
+    string savePath = "savegame.txt";   // per session when several share a directory
+
+    explicit CommandSession(GameEngine& g) : game(g) {}
+
+    void feed(const char* data, size_t n) {
+        const char* end = data + n;
+        if (!partial.empty() || skipping) {
+            const char* nl = (const char*)memchr(data, '\n', n);
+            if (!nl) { carry(data, end); return; }
+            carry(data, nl);
+            if (!skipping) run(partial);
+            partial.clear();
+            skipping = false;
+            data = nl + 1;
+        }
+        while (data < end) {
+            const char* nl = (const char*)memchr(data, '\n', end - data);
+            if (!nl) { carry(data, end); return; }
+            run(string_view(data, nl - data));
+            data = nl + 1;
+        }
+    }
+
+    // Input closed: a last line without a newline still counts.
+    void finish() {
+        if (!partial.empty() && !skipping) run(partial);
+        partial.clear();
+        skipping = false;
+    }
+
+private:
+    void carry(const char* from, const char* to) {
+        if (skipping) return;
+        if (partial.size() + (to - from) > MAX_LINE) {
+            partial.clear();
+            skipping = true;
+            fail("line too long");
+            return;
+        }
+        partial.append(from, to);
+    }
+
+    static string_view trim(string_view s) {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+        return s;
+    }
+
+    void run(string_view line) {
+        if (line.size() > MAX_LINE) { fail("line too long"); return; }
+        line = trim(line);
+        if (line.empty()) return;
+        size_t space = line.find_first_of(" \t");
+        string_view verb = line.substr(0, space);
+        string_view args = space == string_view::npos ? string_view() : trim(line.substr(space));
+        commands++;
+
+        if (verb == "1" || verb == "2") choose(verb);
+        else if (verb == "choice") choose(args);
+        else if (verb == "wait") wait();
+        else if (verb == "undo") undo();
+        else if (verb == "redo") travel(game.redoGame(), "nothing to redo");
+        else if (verb == "jump") jump(args);
+        else if (verb == "branch") branch(args);
+        else if (verb == "use") use(args);
+        else if (verb == "inventory") { out += "OK "; out += game.getInventoryString(); out += '\n'; }
+        else if (verb == "save") save();
+        else if (verb == "status") { out += "OK"; status(); }
+        else fail("unknown command");
+    }
+
+    void choose(string_view args) {
+        if (args != "1" && args != "2") { fail("choice must be 1 or 2"); return; }
+        if (game.current->isEnding) { fail("game over"); return; }
+        const StoryNode* from = game.current;
+        bool dismissal = game.eventActive;   // this choice only clears the event
+        game.makeChoice(args[0] - '0');
+        if (!dismissal) {
+            if (analytics) analytics->record(turnRecord(sessionId, turns, game, from, args[0] - '0'));
+            turns++;
+        }
+        out += "OK";
+        status();
+    }
+
+    void wait() {
+        if (game.current->isEnding) { fail("game over"); return; }
+        game.makeChoice(0);
+        out += "OK";
+        status();
+    }
+
+    void undo() { travel(game.undoGame(), "nothing to undo"); }
+
+    void jump(string_view args) {
+        int turn;
+        if (!parseNumber(args, turn)) { fail("jump to which turn?"); return; }
+        travel(game.jumpToTurn(turn), "no such turn");
+    }
+
+    // Replies with the branch count too: " branch 2 of 3".
+    void branch(string_view args) {
+        int n;
+        if (!parseNumber(args, n)) { fail("which branch?"); return; }
+        if (!game.switchBranch(n - 1)) { fail("no such branch"); return; }
+        out += "OK branch ";
+        number(n);
+        out += " of ";
+        number(game.history.branchCount());
+        status();
+    }
+
+    void travel(bool moved, const char* nowhere) {
+        if (!moved) { fail(nowhere); return; }
+        out += "OK";
+        status();
+    }
+
+    static bool parseNumber(string_view s, int& v) {
+        auto r = from_chars(s.data(), s.data() + s.size(), v);
+        return !s.empty() && r.ec == errc() && r.ptr == s.data() + s.size();
+    }
+
+    void use(string_view item) {
+        if (item.empty()) { fail("use what?"); return; }
+        if (!game.useItem(string(item))) { fail("not in pack"); return; }
+        out += "OK";
+        status();
+    }
+
+    void save() {
+        ScopedTimer timing(T_SAVE_FILE);
+        ofstream file(savePath);
+        file << game.current->id << endl;
+        file << game.player.health << " " << game.player.hunger << " " << game.player.energy << endl;
+        if (!file) { fail("could not write " + savePath); return; }
+        out += "OK saved\n";
+    }
+
+    void number(int v) {
+        char buf[16];
+        out.append(buf, to_chars(buf, buf + sizeof buf, v).ptr);
+    }
+
+    // " scene 4 health 90 hunger 5 energy 90[ event <text>][ ending]\n"
+    void status() {
+        out += " scene "; number(game.current->id);
+        out += " health "; number(game.player.health);
+        out += " hunger "; number(game.player.hunger);
+        out += " energy "; number(game.player.energy);
+        if (game.eventActive) { out += " event "; out += game.activeEvent.description; }
+        if (game.current->isEnding) out += " ending";
+        out += '\n';
+    }
+
+    void fail(string_view why) {
+        errors++;
+        out += "ERR ";
+        out += why;
+        out += '\n';
+    }
+};
+
+#endif
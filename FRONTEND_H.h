@@ -0,0 +1,234 @@
+#ifndef FRONTEND_H
+#define FRONTEND_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include "GAME_ENGINE_H.h"
+
+using namespace std;
+
+// --- FRAMEBUFFER ---
+// 0xAARRGGBB. Alpha is only a mask: 0 = skip, anything else = draw.
+struct Framebuffer {
+    int width, height;
+    vector<uint32_t> pixels;
+
+    Framebuffer(int w, int h) : width(w), height(h), pixels((size_t)w * h, 0xFF000000) {}
+
+    void clear(uint32_t color) { fill(pixels.begin(), pixels.end(), color); }
+
+    bool writePPM(const string& path) const {
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        fprintf(f, "P6\n%d %d\n255\n", width, height);
+        vector<uint8_t> row(width * 3);
+        for (int y = 0; y < height; y++) {
+            const uint32_t* p = &pixels[(size_t)y * width];
+            for (int x = 0; x < width; x++) {
+                row[x * 3] = (p[x] >> 16) & 0xFF;
+                row[x * 3 + 1] = (p[x] >> 8) & 0xFF;
+                row[x * 3 + 2] = p[x] & 0xFF;
+            }
+            fwrite(row.data(), 1, row.size(), f);
+        }
+        return fclose(f) == 0;
+    }
+};
+
+// --- SPRITE ATLAS ---
+// Everything the scene draws lives in one image: the wolf walk cycle and
+// the three parallax strips. No asset files; the art is generated.
+struct SpriteRect {
+    int x, y, w, h;
+    bool opaque;   // no transparent pixels: rows can be copied whole
+};
+
+const int WOLF_FRAMES = 8;
+const int WOLF_W = 48, WOLF_H = 32;
+const int STRIP_W = 512;
+
+struct SpriteAtlas {
+    int width = STRIP_W, height = 0;
+    vector<uint32_t> pixels;
+    SpriteRect wolf[WOLF_FRAMES];
+    SpriteRect sky, mountains, trees, snow;
+
+    SpriteAtlas() {
+        sky = {0, 0, STRIP_W, 120, true};
+        mountains = {0, 120, STRIP_W, 80, false};
+        trees = {0, 200, STRIP_W, 70, false};
+        snow = {0, 270, STRIP_W, 30, true};
+        for (int i = 0; i < WOLF_FRAMES; i++) wolf[i] = {i * WOLF_W, 300, WOLF_W, WOLF_H, false};
+        height = 300 + WOLF_H;
+        pixels.assign((size_t)width * height, 0);
+
+        for (int y = 0; y < sky.h; y++)
+            for (int x = 0; x < STRIP_W; x++) put(x, sky.y + y, 0xFF000000 | ((20 + y / 3) << 16) | ((30 + y / 3) << 8) | (70 + y / 2));
+        for (int x = 0; x < STRIP_W; x++) {
+            int peak = (int)(40 + 25 * sin(x * 6.2831853 / STRIP_W * 3) + 10 * sin(x * 6.2831853 / STRIP_W * 7));
+            for (int y = peak; y < mountains.h; y++) put(x, mountains.y + y, y < peak + 6 ? 0xFFE8EEF5 : 0xFF4A5568);
+            int tree = x % 64;
+            int top = 10 + (x / 64 % 3) * 8;
+            for (int y = top; y < trees.h; y++) {
+                int half = (y - top) / 3;
+                if (abs(tree - 32) <= half || (abs(tree - 32) <= 2 && y > trees.h - 12)) put(x, trees.y + y, 0xFF1F3D2B);
+            }
+            for (int y = 0; y < snow.h; y++) put(x, snow.y + y, y < 3 ? 0xFFFFFFFF : 0xFFDDE4EE);
+        }
+        for (int f = 0; f < WOLF_FRAMES; f++) drawWolf(f);
+    }
+
+private:
+    void put(int x, int y, uint32_t c) { pixels[(size_t)y * width + x] = c; }
+
+    void drawWolf(int frame) {
+        int ox = wolf[frame].x, oy = wolf[frame].y;
+        double phase = frame * 6.2831853 / WOLF_FRAMES;
+        auto dot = [&](int x, int y, uint32_t c) {
+            if (x >= 0 && x < WOLF_W && y >= 0 && y < WOLF_H) put(ox + x, oy + y, c);
+        };
+        const uint32_t fur = 0xFF8A8F99, dark = 0xFF50545C;
+        for (int y = 10; y < 20; y++)
+            for (int x = 8; x < 38; x++) dot(x, y, fur);                    // body
+        for (int y = 5; y < 14; y++)
+            for (int x = 36; x < 46; x++) dot(x, y, fur);                   // head
+        dot(42, 7, 0xFF101010);                                               // eye
+        for (int x = 0; x < 9; x++) dot(x, 11 + x / 3, dark);                 // tail
+        int legs[4] = {11, 16, 30, 35};
+        for (int i = 0; i < 4; i++) {
+            int swing = (int)lround(3 * sin(phase + (i % 2 ? 3.14159 : 0)));
+            for (int y = 20; y < 31; y++) dot(legs[i] + swing * (y - 20) / 10, y, dark);
+        }
+    }
+};
+
+// --- SPRITE BATCH ---
+// Draw calls are only recorded; flush() sorts them back to front once and
+// blits them in a single pass. Opaque spans copy whole rows, the rest skip
+// transparent texels.
+struct DrawCall {
+    int layer;
+    SpriteRect src;
+    int x, y;
+};
+
+struct SpriteBatch {
+    const SpriteAtlas& atlas;
+    vector<DrawCall> calls;
+
+    explicit SpriteBatch(const SpriteAtlas& a) : atlas(a) {}
+
+    void draw(const SpriteRect& src, int x, int y, int layer) { calls.push_back({layer, src, x, y}); }
+
+    // A strip repeated across the screen, scrolled by offset pixels.
+    void drawScrolling(const SpriteRect& strip, double offset, int y, int layer, int screenWidth) {
+        int start = -(int)fmod(offset, (double)strip.w);
+        if (start > 0) start -= strip.w;
+        for (int x = start; x < screenWidth; x += strip.w) draw(strip, x, y, layer);
+    }
+
+    void flush(Framebuffer& fb) {
+        stable_sort(calls.begin(), calls.end(), [](const DrawCall& a, const DrawCall& b) { return a.layer < b.layer; });
+        for (const DrawCall& c : calls) blit(fb, c);
+        calls.clear();
+    }
+
+private:
+    void blit(Framebuffer& fb, const DrawCall& c) {
+        int x0 = max(0, c.x), x1 = min(fb.width, c.x + c.src.w);
+        int y0 = max(0, c.y), y1 = min(fb.height, c.y + c.src.h);
+        if (x0 >= x1 || y0 >= y1) return;
+        for (int y = y0; y < y1; y++) {
+            const uint32_t* src = &atlas.pixels[(size_t)(c.src.y + y - c.y) * atlas.width + c.src.x + (x0 - c.x)];
+            uint32_t* dst = &fb.pixels[(size_t)y * fb.width + x0];
+            int n = x1 - x0;
+            if (c.src.opaque) {
+                memcpy(dst, src, n * sizeof(uint32_t));
+            } else {
+                for (int i = 0; i < n; i++)
+                    if (src[i] >> 24) dst[i] = src[i];
+            }
+        }
+    }
+};
+
+// --- GAME LOOP ---
+// Simulation runs at a fixed step no matter how fast frames are drawn;
+// rendering blends the last two simulated states. Story input is queued
+// and applied on the next simulation step, never blocking a frame.
+struct SceneState {
+    double wolfX = 40;     // screen position
+    double scroll = 0;     // world distance travelled
+    double animTime = 0;
+};
+
+struct FrontEnd {
+    static constexpr double STEP = 1.0 / 60.0;
+    const double WALK_SPEED = 60;   // pixels per second
+
+    GameEngine* game;
+    SpriteAtlas atlas;
+    SpriteBatch batch;
+    Framebuffer frame;
+    SceneState previous, current;
+    double accumulator = 0;
+    double walkLeft = 0;            // seconds of walking still to show
+    deque<int> pendingChoices;
+    long long steps = 0;
+
+    FrontEnd(GameEngine* g, int w, int h) : game(g), batch(atlas), frame(w, h) {}
+
+    void queueChoice(int choice) { pendingChoices.push_back(choice); }
+
+    // Advances by one real frame of length dt and draws it.
+    void tick(double dt) {
+        accumulator += min(dt, 0.25);   // don't spiral after a stall
+        while (accumulator >= STEP) {
+            previous = current;
+            update(STEP);
+            accumulator -= STEP;
+            steps++;
+        }
+        render(accumulator / STEP);
+    }
+
+private:
+    void update(double dt) {
+        if (!pendingChoices.empty()) {
+            if (game && game->current && !game->current->isEnding) game->makeChoice(pendingChoices.front());
+            pendingChoices.pop_front();
+            walkLeft = 2.0;   // each choice walks the wolf to the next scene
+        }
+        if (walkLeft > 0) {
+            walkLeft -= dt;
+            current.scroll += WALK_SPEED * dt;
+            current.animTime += dt;
+        }
+    }
+
+    void render(double alpha) {
+        double scroll = previous.scroll + (current.scroll - previous.scroll) * alpha;
+        double anim = previous.animTime + (current.animTime - previous.animTime) * alpha;
+        int groundY = frame.height - atlas.snow.h;
+
+        batch.drawScrolling(atlas.sky, 0, 0, 0, frame.width);
+        batch.drawScrolling(atlas.mountains, scroll * 0.2, groundY - atlas.trees.h - 40, 1, frame.width);
+        batch.drawScrolling(atlas.trees, scroll * 0.5, groundY - atlas.trees.h + 4, 2, frame.width);
+        batch.drawScrolling(atlas.snow, scroll, groundY, 3, frame.width);
+        int f = (int)(anim * 10) % WOLF_FRAMES;
+        batch.draw(atlas.wolf[f], (int)current.wolfX, groundY - WOLF_H + 6, 4);
+        if (atlas.sky.h < frame.height) {
+            // sky strip is shorter than the screen: fill the gap once, under everything
+            fill(frame.pixels.begin() + (size_t)atlas.sky.h * frame.width, frame.pixels.end(), 0xFF3A4A7A);
+        }
+        batch.flush(frame);
+    }
+};
+
+#endif
@@ -0,0 +1,203 @@
+// Coverage-guided playthrough fuzzer.
+// Build: g++ -O2 -std=c++17 -pthread Fuzz.cpp -o fuzz
+// Run:   ./fuzz [threads] [playthroughs]
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include "GAME_ENGINE_H.h"
+#include "THREAD_POOL_H.h"
+
+using namespace std;
+
+// ---------------- INPUTS ----------------
+// One byte per input: 0 = choice A, 1 = choice B, 2 = undo, 3+k = use pickup k.
+typedef vector<uint8_t> Input;
+
+struct FuzzRng {
+    uint64_t s;
+    uint64_t next() { s ^= s << 13; s ^= s >> 7; s ^= s << 17; return s; }
+    int below(int n) { return (int)(next() % (uint64_t)n); }
+};
+
+// ---------------- COVERAGE ----------------
+enum Feature { F_NODE, F_EDGE, F_ENDING, F_STAT, F_PICKUP, F_KINDS };
+const char* FEATURE_NAMES[F_KINDS] = {"scenes", "edges", "endings", "stat ranges", "pickups"};
+const int FEATURE_BITS = 1 << 16;
+
+struct Coverage {
+    vector<atomic<uint8_t>> seen;
+    atomic<int> count[F_KINDS];
+    vector<atomic<uint8_t>> nodeSeen;
+
+    explicit Coverage(int maxId) : seen(FEATURE_BITS), nodeSeen(maxId + 1) {
+        for (auto& b : seen) b = 0;
+        for (auto& b : nodeSeen) b = 0;
+        for (auto& c : count) c = 0;
+    }
+
+    // True the first time any thread reports this feature.
+    bool hit(Feature kind, int a, int b = 0) {
+        uint64_t h = zobristMix(((uint64_t)kind << 48) ^ ((uint64_t)(uint32_t)a << 20) ^ (uint32_t)b);
+        atomic<uint8_t>& bit = seen[h % FEATURE_BITS];
+        if (bit.load(memory_order_relaxed) || bit.exchange(1)) return false;
+        count[kind]++;
+        return true;
+    }
+};
+
+// ---------------- FUZZER ----------------
+struct Fuzzer {
+    const Story* story;
+    int maxId = 0;
+    int reachable = 0;
+    vector<char> reachableSlot;
+    Coverage* coverage;
+    ThreadPool& pool;
+    long long budget;
+    atomic<long long> runs{0};
+    atomic<uint64_t> seeds{1};
+
+    mutex corpusLock;
+    vector<Input> corpus;
+    mutex findingsLock;
+    set<string> findings;
+
+    Fuzzer(const Story& s, ThreadPool& p, long long playthroughs)
+        : story(&s), reachableSlot(s.count, 0), pool(p), budget(playthroughs) {
+        // One walk over the story for what can be reached and the largest id.
+        vector<int> todo = {0};
+        reachableSlot[0] = 1;
+        while (!todo.empty()) {
+            const StoryNode& n = s.nodes[todo.back()];
+            todo.pop_back();
+            maxId = max(maxId, n.id);
+            reachable++;
+            for (int next : {n.left, n.right})
+                if (next >= 0 && !reachableSlot[next]) { reachableSlot[next] = 1; todo.push_back(next); }
+        }
+        coverage = new Coverage(maxId);
+    }
+    ~Fuzzer() { delete coverage; }
+
+    void report(const string& what) {
+        lock_guard<mutex> guard(findingsLock);
+        findings.insert(what);
+    }
+
+    // One playthrough on a fresh session over the shared (read-only) story.
+    bool run(const Input& in, uint64_t seed) {
+        GameEngine g;
+        g.start(*story);
+        g.seed(seed);
+
+        bool fresh = coverage->hit(F_NODE, g.current->id);
+        coverage->nodeSeen[g.current->id] = 1;
+        const vector<Pickup>& pickups = storyPickups();
+        for (uint8_t op : in) {
+            const StoryNode* from = g.current;
+            if (op < 2) {
+                const StoryNode* next = story->next(from, op + 1);
+                if (!next && !from->isEnding)
+                    report("scene " + to_string(from->id) + ": choice " + (op == 0 ? "A" : "B") + " leads nowhere");
+                if (from->isEnding) break;
+                g.makeChoice(op + 1);
+            } else if (op == 2) {
+                g.undoGame();
+            } else {
+                g.useItem(pickups[(op - 3) % pickups.size()].name);
+            }
+
+            if (!g.current) { report("session lost its scene (current == nullptr)"); return true; }
+            if (g.current != from) {
+                fresh |= coverage->hit(F_NODE, g.current->id);
+                fresh |= coverage->hit(F_EDGE, from->id, g.current->id);
+                coverage->nodeSeen[g.current->id] = 1;
+                if (g.current->isEnding) fresh |= coverage->hit(F_ENDING, g.current->id);
+                for (size_t k = 0; k < pickups.size(); k++)
+                    if (pickups[k].nodeId == g.current->id) fresh |= coverage->hit(F_PICKUP, (int)k);
+            }
+            fresh |= coverage->hit(F_STAT, 0, g.player.health / 10);
+            fresh |= coverage->hit(F_STAT, 1, g.player.hunger / 10);
+            fresh |= coverage->hit(F_STAT, 2, g.player.energy / 10);
+        }
+        return fresh;
+    }
+
+    Input mutate(Input in, FuzzRng& rng) {
+        int edits = 1 + rng.below(4);
+        for (int e = 0; e < edits; e++) {
+            int kind = in.empty() ? 0 : rng.below(4);
+            int ops = 3 + (int)storyPickups().size();
+            if (kind == 0) in.insert(in.begin() + rng.below((int)in.size() + 1), (uint8_t)rng.below(ops));
+            else if (kind == 1) in[rng.below((int)in.size())] = (uint8_t)rng.below(ops);
+            else if (kind == 2) in.erase(in.begin() + rng.below((int)in.size()));
+            else {
+                lock_guard<mutex> guard(corpusLock);
+                if (!corpus.empty()) {
+                    const Input& other = corpus[rng.below((int)corpus.size())];
+                    in.resize(rng.below((int)in.size() + 1));
+                    in.insert(in.end(), other.begin() + rng.below((int)other.size() + 1), other.end());
+                }
+            }
+        }
+        if (in.size() > 64) in.resize(64);
+        return in;
+    }
+
+    // Inputs that found something new get many children, the rest one:
+    // new coverage is where the pool spends its time.
+    void schedule(Input in) {
+        pool.submit([this, in] {
+            if (runs++ >= budget) return;
+            uint64_t seed = seeds++;
+            FuzzRng rng{zobristMix(seed)};
+            bool fresh = run(in, seed);
+            if (fresh) {
+                lock_guard<mutex> guard(corpusLock);
+                corpus.push_back(in);
+            }
+            for (int c = fresh ? 8 : 1; c > 0; c--) schedule(mutate(in, rng));
+        });
+    }
+};
+
+// ---------------- MAIN ----------------
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? atoi(argv[1]) : (int)thread::hardware_concurrency();
+    long long playthroughs = argc > 2 ? atoll(argv[2]) : 200000;
+
+    GameEngine game;
+    game.init();
+
+    ThreadPool pool(threads);
+    Fuzzer fuzz(*game.story, pool, playthroughs);
+    auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < pool.size() * 4; i++) fuzz.schedule(Input(i % 8, (uint8_t)(i % 2)));
+    pool.wait();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    long long done = min(fuzz.runs.load(), playthroughs);
+    cout << done << " playthroughs on " << pool.size() << " threads in " << secs << " s ("
+         << (long long)(done / secs) << "/s), corpus " << fuzz.corpus.size() << "\n\ncoverage:\n";
+    for (int k = 0; k < F_KINDS; k++) cout << "  " << FEATURE_NAMES[k] << ": " << fuzz.coverage->count[k] << "\n";
+
+    cout << "\nscenes reached " << fuzz.coverage->count[F_NODE] << "/" << fuzz.reachable << ", never reached:";
+    int missing = 0;
+    for (int slot = 0; slot < game.story->count; slot++) {
+        int id = game.story->nodes[slot].id;
+        if (fuzz.reachableSlot[slot] && !fuzz.coverage->nodeSeen[id]) { cout << " " << id; missing++; }
+    }
+    if (!missing) cout << " none";
+    cout << "\npickups never triggered:";
+    for (const Pickup& p : storyPickups())
+        if (p.nodeId > fuzz.maxId || !fuzz.coverage->nodeSeen[p.nodeId]) cout << " [" << p.name << " @" << p.nodeId << "]";
+
+    cout << "\n\nfindings: " << fuzz.findings.size() << "\n";
+    for (const string& f : fuzz.findings) cout << "  " << f << "\n";
+    return fuzz.findings.empty() ? 0 : 1;
+}
@@ -8,624 +8,353 @@
 #include <cstdlib>
 #include <ctime>
 #include <algorithm> // Added for min/max
+#include "ZOBRIST_H.h"
+#include "METRICS_H.h"
+#include "INBOX_H.h"
+#include "WORLD_H.h"
+#include "RULES_H.h"
+#include "GAME_STATE_H.h"
+#include "HISTORY_H.h"
+#include "STORY_TABLE_H.h"
 
 using namespace std;
 
-// --- STRUCTS ---
-struct Wolf {
-    int health = 100;
-    int hunger = 0;
-    int energy = 100;
-};
-
-struct Item {
+// --- STORY RULES (shared with the solver) ---
+struct Pickup {
+    int nodeId;
     string name;
     string type;
     int effect;
-    Item* next;
-};
-
-struct StoryNode {
-    int id;
-    string description;
-    string choiceA;
-    string choiceB;
-    StoryNode* left;
-    StoryNode* right;
-    bool isEnding;
-};
-
-struct GameState {
-    Wolf savedWolf;
-    int savedNodeId;
-    Item* savedInventory;
-    GameState* next;
-};
-
-struct GameEvent {
-    string description;
-    int priority;
-    int healthEffect;
 };
 
-struct CompareEvent {
-    bool operator()(GameEvent const& e1, GameEvent const& e2) {
-        return e1.priority > e2.priority;
-    }
-};
+inline const vector<Pickup>& storyPickups() {
+    static const vector<Pickup> table = {
+        {8, "Medical Herbs", "Medical", 30},
+        {13, "Fresh Venison", "Food", 40},
+        {4, "Scraps", "Food", 10},
+    };
+    return table;
+}
+
+const GameEvent SNOWSTORM = {SNOWSTORM_TEXT, 2, SNOWSTORM_EFFECT};   // at SNOWSTORM_CHANCE
+// Only with a shared world attached (see WORLD_H.h).
+const GameEvent HUNTER_SHOT = {"A hunter's shot grazes you! -20 Health", 1, statEffect(STAT_HEALTH, -20)};
+const GameEvent PREY_CAUGHT = {"You catch a hare on the way. -15 Hunger", 3, statEffect(STAT_HUNGER, -15)};
+const GameEvent LAST_STRETCH = {"The last stretch turns against you. -60 Health", 0, statEffect(STAT_HEALTH, -60)};
 
 // --- THE ENGINE CLASS ---
 struct GameEngine {
     // DATA
     Wolf player;
-    Item* inventoryHead = nullptr;
-    StoryNode* root = nullptr;
-    StoryNode* current = nullptr;
-    GameState* stackTop = nullptr;
+    shared_ptr<const Item> inventoryHead;   // persistent, see GAME_STATE_H.h
+    const Story* story = nullptr;        // shared, read-only
+    const StoryNode* current = nullptr;
+    History history;                     // undo, over snapshots interned in *snapshots
+    SnapshotStore* snapshots = &sharedSnapshots();
+    bool undoable = true;                // false: turns record no undo points (scratch engines)
     priority_queue<GameEvent, vector<GameEvent>, CompareEvent> eventQueue;
     
     string currentMessage = ""; 
     bool eventActive = false;
     GameEvent activeEvent;
 
+    // Events from other threads (admin tools, weather, broadcasts). They
+    // join eventQueue at the start of the session's next turn.
+    MpscInbox<GameEvent> inbox{64};
+
+    // Shared weather and wildlife, read once per turn. Without one the
+    // session keeps the fixed snowstorm odds and nothing else.
+    const WorldSim* world = nullptr;
+
+    // For replays (REPLAY_H.h). With drainLog set, every event taken from
+    // the inbox is also appended to it; worldSeen is what the last turn read
+    // from the world. A replay sets replayWorld, and turns read it instead.
+    vector<GameEvent>* drainLog = nullptr;
+    WorldState worldSeen;
+    const WorldState* replayWorld = nullptr;
+
+    // Told after every turn, item use and time travel, so whatever drives
+    // the engine also drives what listens (story scripts, SCRIPTS_H.h).
+    struct Listener {
+        virtual void turnPlayed(const StoryNode* from, int choice) = 0;
+        virtual void itemUsed(const string& name) = 0;
+        virtual void timeTravelled(const StoryNode* from) = 0;
+        virtual ~Listener() = default;
+    };
+    Listener* listener = nullptr;
+
+    // Zobrist parts, kept up to date by every change (see ZOBRIST_H.h)
+    uint64_t fieldHash = 0;   // scene + stats, XOR
+    uint64_t itemHash = 0;    // pack, sum
+    uint64_t eventHash = 0;   // pending events, sum
+
+    // Rendered pack, patched by addItem/useItem. Anything that swaps the
+    // whole list (undo, restore) just sets inventoryDirty.
+    string inventoryText = "Pack: Empty";
+    bool inventoryDirty = false;
+
+    // Per-session dice, so a seed replays the same session on any machine
+    uint64_t rngState = 1;
+
+    void seed(uint64_t s) { rngState = s ? s : 1; }
+
+    int rollPercent() { return ::rollPercent(rngState); }
+
+    // Safe from any thread. False if the inbox is full.
+    bool postEvent(const GameEvent& e) { return inbox.tryPush(e); }
+
+    void drainInbox() {
+        inbox.drain([this](GameEvent&& e) {
+            if (drainLog) drainLog->push_back(e);
+            eventHash += eventKey(e);
+            eventQueue.push(move(e));
+        });
+    }
+
+    // --- STATE HASH ---
+
+    static uint64_t wolfKey(const Wolf& w) {
+        return zobristKey(Z_HEALTH, w.health) ^ zobristKey(Z_HUNGER, w.hunger) ^ zobristKey(Z_ENERGY, w.energy);
+    }
+    static uint64_t itemKey(const Item& i) { return zobristThing(Z_ITEM, i.name, i.type, i.effect); }
+    static uint64_t eventKey(const GameEvent& e) {
+        uint64_t h = zobristThing(Z_EVENT, e.description, "", e.priority);
+        for (int s = 0; s < STAT_COUNT; s++) h = zobristMix(h ^ (uint32_t)e.effect.delta[s]);
+        return h;
+    }
+
+    // Identical for identical (scene, stats, pack, pending events) states.
+    uint64_t stateHash() const {
+        uint64_t h = fieldHash ^ zobristMix(itemHash) ^ zobristMix(eventHash ^ zobristKey(Z_BAG, 0));
+        if (eventActive) h ^= zobristKey(Z_ACTIVE_EVENT, 0) ^ eventKey(activeEvent);
+        return h;
+    }
+
+    // From scratch; for code that changes player/current directly.
+    void rehashAll() {
+        fieldHash = wolfKey(player) ^ (current ? zobristKey(Z_NODE, current->id) : 0);
+        itemHash = 0;
+        for (const Item* t = inventoryHead.get(); t; t = t->next.get()) itemHash += itemKey(*t);
+        eventHash = 0;
+        priority_queue<GameEvent, vector<GameEvent>, CompareEvent> pending = eventQueue;
+        for (; !pending.empty(); pending.pop()) eventHash += eventKey(pending.top());
+    }
+
     // --- NEW INVENTORY FUNCTIONS ---
 
-    void useItem(string itemName) {
+    // Uses the most recently found item by that name. False if there is none.
+    bool useItem(string itemName) {
         if (!inventoryHead) {
             currentMessage = "Your pack is empty.";
-            return;
+            return false;
         }
-        Item* curr = inventoryHead;
-        Item* prev = nullptr;
-        while (curr) {
+        // The pack is newest first but shown oldest first, so curr's "[name] "
+        // ends where the text of the items walked so far begins.
+        size_t newer = 0;
+        for (const Item* curr = inventoryHead.get(); curr; curr = curr->next.get()) {
+            newer += curr->name.size() + 3;
             if (curr->name == itemName) {
-                if (curr->type == "Food") player.hunger = max(0, player.hunger - curr->effect);
-                else if (curr->type == "Medical") player.health = min(100, player.health + curr->effect);
-                
-                if (!prev) inventoryHead = curr->next;
-                else prev->next = curr->next;
-                delete curr;
+                Wolf before = player;
+                applyEffect(player, curr->onUse);
+
+                fieldHash ^= wolfKey(before) ^ wolfKey(player);
+                itemHash -= itemKey(*curr);
+                if (!inventoryDirty) inventoryText.erase(inventoryText.size() - newer, curr->name.size() + 3);
+                inventoryHead = packWithout(inventoryHead, curr);   // curr is gone from here on
+                if (!inventoryHead) inventoryText = "Pack: Empty";
                 currentMessage = "Used " + itemName;
-                return;
+                if (listener) listener->itemUsed(itemName);
+                return true;
             }
-            prev = curr;
-            curr = curr->next;
         }
+        return false;
     }
 
-    string getInventoryString() {
-        if (!inventoryHead) return "Pack: Empty";
-        string s = "Pack: ";
-        Item* t = inventoryHead;
-        while (t) {
-            s += "[" + t->name + "] ";
-            t = t->next;
+    // Oldest item first, in the order they were found.
+    const string& getInventoryString() {
+        if (inventoryDirty) {
+            inventoryText = inventoryHead ? "Pack: " : "Pack: Empty";
+            vector<const Item*> found;
+            for (const Item* t = inventoryHead.get(); t; t = t->next.get()) found.push_back(t);
+            for (size_t k = found.size(); k-- > 0;) appendItemText(found[k]->name);
+            inventoryDirty = false;
         }
-        return s;
+        return inventoryText;
+    }
+
+    void appendItemText(const string& name) {
+        inventoryText += '[';
+        inventoryText += name;
+        inventoryText += "] ";
     }
 
     // --- HELPER FUNCTIONS ---
 
-    StoryNode* createNode(int id, string desc, string a, string b, bool end) {
-        StoryNode* node = new StoryNode;
-        node->id = id; node->description = desc; node->choiceA = a; node->choiceB = b;
-        node->left = nullptr; node->right = nullptr; node->isEnding = end;
-        return node;
-    }
+    // O(1) through the story's id index.
+    const StoryNode* findNode(int id) const { return story ? story->find(id) : nullptr; }
 
     void addItem(string n, string t, int e) {
-        Item* newItem = new Item;
-        newItem->name = n; newItem->type = t; newItem->effect = e; newItem->next = nullptr;
-        if (!inventoryHead) inventoryHead = newItem;
-        else {
-            Item* temp = inventoryHead;
-            while (temp->next) temp = temp->next;
-            temp->next = newItem;
+        metricsCount(C_ALLOCS);
+        Item item{n, t, e, itemEffect(t, e), nullptr};
+        itemHash += itemKey(item);
+        bool first = !inventoryHead;
+        inventoryHead = packWith(inventoryHead, move(item));
+        if (!inventoryDirty) {
+            if (first) inventoryText = "Pack: ";
+            appendItemText(n);
         }
         currentMessage = "Found: " + n;
     }
 
-    Item* cloneInventory(Item* originalHead) {
-        if (!originalHead) return nullptr;
-        Item* newHead = new Item(*originalHead);
-        newHead->next = nullptr;
-        Item* currOrig = originalHead->next;
-        Item* currNew = newHead;
-        while (currOrig) {
-            currNew->next = new Item(*currOrig);
-            currNew->next->next = nullptr;
-            currNew = currNew->next;
-            currOrig = currOrig->next;
+    // --- SNAPSHOTS AND UNDO ---
+
+    // The whole state as a snapshot; the pack is shared, not copied.
+    Snapshot capture() const {
+        Snapshot s;
+        s.hash = stateHash();
+        s.wolf = player;
+        s.nodeId = current ? current->id : 0;
+        s.items = inventoryHead;
+        if (!eventQueue.empty()) {
+            auto pending = eventQueue;
+            vector<GameEvent> events;
+            for (; !pending.empty(); pending.pop()) events.push_back(pending.top());
+            sort(events.begin(), events.end(), eventBefore);
+            s.events = make_shared<const vector<GameEvent>>(move(events));
         }
-        return newHead;
+        s.eventActive = eventActive;
+        if (eventActive) s.activeEvent = activeEvent;
+        return s;
     }
 
-    void saveGame() {
-        GameState* newState = new GameState;
-        newState->savedWolf = player;
-        newState->savedNodeId = current->id;
-        newState->savedInventory = cloneInventory(inventoryHead);
-        newState->next = stackTop;
-        stackTop = newState;
+    // Puts the session into a snapshot's state: the scene through the
+    // story's id index, the pack by pointer. History and dice are untouched.
+    void restore(const Snapshot& s) {
+        player = s.wolf;
+        const StoryNode* at = current && current->id == s.nodeId ? current : findNode(s.nodeId);
+        if (at) current = at;
+        inventoryHead = s.items;
+        inventoryDirty = true;
+        eventQueue = priority_queue<GameEvent, vector<GameEvent>, CompareEvent>();
+        if (s.events)
+            for (const GameEvent& e : *s.events) eventQueue.push(e);
+        eventActive = s.eventActive;
+        activeEvent = s.activeEvent;
+        rehashAll();
     }
 
-    void undoGame() {
-        if (!stackTop) { currentMessage = "Nothing to undo!"; return; }
-        GameState* state = stackTop;
-        stackTop = stackTop->next;
-        player = state->savedWolf;
-        inventoryHead = state->savedInventory;
-        
-        // Manual search logic for your tree
-        if (state->savedNodeId == 1) current = root;
-        else if (state->savedNodeId == 2) current = root->left;
-        else if (state->savedNodeId == 3) current = root->right;
-        else if (state->savedNodeId == 4) current = root->left->left;
-        else if (state->savedNodeId == 5) current = root->left->right;
-        else if (state->savedNodeId == 6) current = root->right->left;
-        else if (state->savedNodeId == 7) current = root->right->right;
-        // ... (can add more ID checks here)
-
-        delete state;
-        currentMessage = "Time rewound!";
+    // The state before a turn, as an undo point. Nothing is copied: the
+    // snapshot is interned, and unchanged since the last point is not
+    // recorded twice.
+    void saveGame() {
+        ScopedTimer timing(T_SAVE);
+        history.commit(snapshots->intern(capture()));
     }
 
-    // --- INITIALIZATION (YOUR FULL 20+ NODES) ---
-    void init() {
-
-        // -------- MAIN TREE --------
-        StoryNode* n1 = new StoryNode(1,
-            "Echoes After the Storm\nThe storm has ended.\nSnow covers the forest floor.\nThe wolf stands alone.\nThe pack is gone.\nCold and hunger slowly grow.",
-            "Follow blood scent",
-            "Howl and search",
-            false);
-
-        StoryNode* n2 = new StoryNode(2,
-            "The Frozen Stream\nA frozen stream blocks the path.\nThe ice cracks under weight.\nOne mistake could mean death.",
-            "Cross the ice",
-            "Take long path",
-            false);
-
-        StoryNode* n3 = new StoryNode(3,
-            "Fading Paw Prints\nOld wolf tracks appear in the snow.\nThey are faint and disappearing.\nHope remains, but danger follows.",
-            "Track prints",
-            "Rest",
-            false);
-
-        StoryNode* n4 = new StoryNode(4,
-            "Cold Wounds\nThe ice breaks beneath the wolf.\nFreezing water burns the skin.\nMovement becomes slow and painful.",
-            "Heal wounds",
-            "Ignore pain",
-            false);
-
-        StoryNode* n5 = new StoryNode(5,
-            "Hunger Without Reward\nThe hunt fails.\nNo prey is found.\nThe stomach tightens with hunger.",
-            "Hunt again",
-            "Rest",
-            false);
-
-        StoryNode* n6 = new StoryNode(6,
-            "See Grey Wolf\nAnother lone wolf appears.\nEyes watch carefully from a distance.\nTrust is uncertain.",
-            "Calm approach",
-            "Avoid and move",
-            false);
-
-        StoryNode* n7 = new StoryNode(7,
-            "Night Beneath Open Sky\nDarkness spreads across the land.\nCold grows stronger.\nSleeping could be dangerous.",
-            "Stay alert",
-            "Sleep",
-            false);
-
-        StoryNode* n8 = new StoryNode(8,
-            "Slow Healing\nThe wolf rests quietly.\nPain fades slowly.\nStaying too long may attract predators.",
-            "Rest longer",
-            "Move before predators",
-            false);
-
-        StoryNode* n9 = new StoryNode(9,
-            "Weak Prey\nA small rabbit runs through the snow.\nIt is fast and alert.\nThe hunt is risky.",
-            "Chase prey",
-            "Ignore prey",
-            false);
-
-        StoryNode* n10 = new StoryNode(10,
-            "Beginnings of Pack\nThe grey wolf stays close.\nTrust begins to form.\nLeadership will soon be tested.",
-            "Lead calmly",
-            "Assert dominance",
-            false);
-
-        StoryNode* n11 = new StoryNode(11,
-            "Sudden Ambush\nAn enemy attacks from the shadows.\nClaws and teeth clash suddenly.",
-            "Fight",
-            "Run away",
-            false);
-
-        StoryNode* n12 = new StoryNode(12,
-            "After Scent of Hunters\nThe air smells of metal and smoke.\nHumans are nearby.\nFew wolves survive this danger.",
-            "Avoid area",
-            "Investigate area",
-            false);
-
-        StoryNode* n13 = new StoryNode(13,
-            "ENDING: Death by Hunger\nNo food is found.\nStrength fades.\nThe body finally gives up.",
-            "",
-            "",
-            true);
-
-        StoryNode* n14 = new StoryNode(14,
-            "Growing Pack\nMore wolves gather together.\nThey look for guidance and strength.",
-            "Expand territory",
-            "Feed and stabilize",
-            false);
-
-        StoryNode* n15 = new StoryNode(15,
-            "Leadership Challenge\nA strong rival steps forward.\nThe pack watches closely.\nBlood may decide leadership.",
-            "Fight rival",
-            "Step aside",
-            false);
-
-        StoryNode* n16 = new StoryNode(16,
-            "ENDING: Death in Weak Battle\nWounds slow movement.\nThe wolf falls in combat.",
-            "",
-            "",
-            true);
-
-        StoryNode* n17 = new StoryNode(17,
-            "Seek Another Weak Prey\nHunger returns.\nDesperation grows.\nRisk increases with every step.",
-            "Chase prey",
-            "Ignore and move",
-            false);
-
-        StoryNode* n18 = new StoryNode(18,
-            "Avoid Area\nThe wolf moves carefully through the land.\nDanger is everywhere.",
-            "Chase prey",
-            "Ignore prey",
-            false);
-
-        StoryNode* n19 = new StoryNode(19,
-            "ENDING: Death by Hunters\nA gunshot breaks the silence.\nThe journey ends in blood and snow.",
-            "",
-            "",
-            true);
-
-        StoryNode* n20 = new StoryNode(20,
-            "ENDING: Alpha Wolf Survives\nThe pack remains strong.\nThe land is protected.",
-            "",
-            "",
-            true);
-
-        StoryNode* n21 = new StoryNode(21,
-            "ENDING: Heroic Sacrifice\nLife is given to protect the pack.\nThe name is remembered.",
-            "",
-            "",
-            true);
-
-        StoryNode* n22 = new StoryNode(22,
-            "ENDING: Strong Alpha\nLeadership is earned.\nLoyalty remains.",
-            "",
-            "",
-            true);
-
-        StoryNode* n23 = new StoryNode(23,
-            "ENDING: Lone Survivor\nThe wolf survives alone.\nFreedom comes with loneliness.",
-            "",
-            "",
-            true);
-
-        StoryNode* n24 = new StoryNode(24,
-            "ENDING: Endless Wanderer\nThe wolf roams the land alone.\nThe journey never truly ends.",
-            "",
-            "",
-            true);
-
-        StoryNode* n25 = new StoryNode(25,
-            "ENDING: Fatal Hunt\nWeakness turns the hunt deadly.\nThe wolf does not survive.",
-            "",
-            "",
-            true);
-
-        StoryNode* n26 = new StoryNode(26,
-            "ENDING: Frozen Hunger\nCold and hunger overcome the body.\nThe night never ends.",
-            "",
-            "",
-            true);
-
-        // -------- CONNECTIONS (UNCHANGED) --------
-        n1->left = n2;   n1->right = n3;
-        n2->left = n4;   n2->right = n5;
-        n3->left = n6;   n3->right = n7;
-        n4->left = n8;   n4->right = n9;
-        n5->left = n9;   n5->right = n7;
-        n6->left = n10;  n6->right = n11;
-        n7->left = n9;   n7->right = n11;
-        n8->left = n9;   n8->right = n6;
-        n9->left = n12;  n9->right = n13;
-        n10->left = n14; n10->right = n15;
-        n11->left = n16; n11->right = n17;
-        n12->left = n18; n12->right = n19;
-        n14->left = n20; n14->right = n21;
-        n15->left = n22; n15->right = n23;
-        n17->left = n9;  n17->right = n24;
-        n18->left = n25; n18->right = n26;
-
-        root = n1;
-        current = root;
+    // Back to the state before the last turn. The state being left is
+    // recorded first, so nothing is thrown away: a new turn from here opens
+    // a branch in the history tree. False if there is nothing to undo.
+    bool undoGame() {
+        return travel([this] { return history.undo(); }, "Time rewound!", "Nothing to undo!");
     }
 
-    void makeChoice(int choice) {
-        if (choice == 1 && current->left)
-            current = current->left;
-        else if (choice == 2 && current->right)
-            current = current->right;
-
-        player.hunger += 5;
-        player.energy -= 5;
+    // Forward again along the branch last taken from here. Using an item
+    // after an undo starts a new branch, so there is then nothing to redo.
+    bool redoGame() {
+        return travel([this] { return history.redo(); }, "Time moves forward again.", "Nothing to redo!");
     }
 
-    void makeChoice(int choice) {
-        if (eventActive) { eventActive = false; return; }
-        saveGame();
-        if (choice == 1 && current->left) { current = current->left; player.energy -= 10; }
-        else if (choice == 2 && current->right) { current = current->right; player.energy -= 5; }
-        player.hunger += 5;
-
-        // Inventory Triggers
-        if (current->id == 8) addItem("Medical Herbs", "Medical", 30);
-        if (current->id == 13) addItem("Fresh Venison", "Food", 40);
-        if (current->id == 4) addItem("Scraps", "Food", 10);
-
-        if ((rand() % 100) < 30) {
-            GameEvent e = {"Sudden Snowstorm! -10 Health", 2, -10};
-            eventQueue.push(e);
-        }
-        if (!eventQueue.empty()) {
-            activeEvent = eventQueue.top();
-            eventQueue.pop();
-            player.health += activeEvent.healthEffect;
-            eventActive = true;
-        }
+    // To an earlier turn of the current branch (0 = the opening scene), in
+    // O(log turns); redo then walks back down the same branch.
+    bool jumpToTurn(int turn) {
+        return travel([&] { return history.jumpTo(turn); }, "Time rewound!", "No such turn!");
     }
 
-    ~GameEngine() {
-        while (inventoryHead) {
-            Item* temp = inventoryHead;
-            inventoryHead = inventoryHead->next;
-            delete temp;
-        }
+    // To the index'th branch taken from the same earlier turn as this one
+    // (0 <= index < history.branchCount(), in the order they were opened).
+    bool switchBranch(int index) {
+        return travel([&] { return history.switchBranch(index); }, "Another path opens.", "No such branch!");
     }
-};
-
-#endif#ifndef GAME_ENGINE_H
-#define GAME_ENGINE_H
-
-#include <iostream>
-#include <string>
-#include <vector>
-#include <queue>
-#include <cstdlib>
-#include <ctime>
-#include <algorithm> // Added for min/max
-
-using namespace std;
 
-// --- STRUCTS ---
-struct Wolf {
-    int health = 100;
-    int hunger = 0;
-    int energy = 100;
-};
-
-struct Item {
-    string name;
-    string type;
-    int effect;
-    Item* next;
-};
-
-struct StoryNode {
-    int id;
-    string description;
-    string choiceA;
-    string choiceB;
-    StoryNode* left;
-    StoryNode* right;
-    bool isEnding;
-};
-
-struct GameState {
-    Wolf savedWolf;
-    int savedNodeId;
-    Item* savedInventory;
-    GameState* next;
-};
-
-struct GameEvent {
-    string description;
-    int priority;
-    int healthEffect;
-};
-
-struct CompareEvent {
-    bool operator()(GameEvent const& e1, GameEvent const& e2) {
-        return e1.priority > e2.priority;
-    }
-};
-
-// --- THE ENGINE CLASS ---
-struct GameEngine {
-    // DATA
-    Wolf player;
-    Item* inventoryHead = nullptr;
-    StoryNode* root = nullptr;
-    StoryNode* current = nullptr;
-    GameState* stackTop = nullptr;
-    priority_queue<GameEvent, vector<GameEvent>, CompareEvent> eventQueue;
-    
-    string currentMessage = ""; 
-    bool eventActive = false;
-    GameEvent activeEvent;
-
-    // --- NEW INVENTORY FUNCTIONS ---
-
-    void useItem(string itemName) {
-        if (!inventoryHead) {
-            currentMessage = "Your pack is empty.";
-            return;
-        }
-        Item* curr = inventoryHead;
-        Item* prev = nullptr;
-        while (curr) {
-            if (curr->name == itemName) {
-                if (curr->type == "Food") player.hunger = max(0, player.hunger - curr->effect);
-                else if (curr->type == "Medical") player.health = min(100, player.health + curr->effect);
-                
-                if (!prev) inventoryHead = curr->next;
-                else prev->next = curr->next;
-                delete curr;
-                currentMessage = "Used " + itemName;
-                return;
-            }
-            prev = curr;
-            curr = curr->next;
-        }
+    // Records the state being left, then restores wherever go() moved the
+    // history to. The dice keep rolling on; they are not rewound.
+    template <class F>
+    bool travel(F go, const char* done, const char* nowhere) {
+        ScopedTimer timing(T_UNDO);
+        history.commit(snapshots->intern(capture()));
+        const Snapshot* to = go();
+        if (!to) { currentMessage = nowhere; return false; }
+        const StoryNode* from = current;
+        restore(*to);
+        currentMessage = done;
+        if (listener) listener->timeTravelled(from);
+        return true;
     }
 
-    string getInventoryString() {
-        if (!inventoryHead) return "Pack: Empty";
-        string s = "Pack: ";
-        Item* t = inventoryHead;
-        while (t) {
-            s += "[" + t->name + "] ";
-            t = t->next;
-        }
-        return s;
-    }
-
-    // --- HELPER FUNCTIONS ---
-
-    StoryNode* createNode(int id, string desc, string a, string b, bool end) {
-        StoryNode* node = new StoryNode;
-        node->id = id; node->description = desc; node->choiceA = a; node->choiceB = b;
-        node->left = nullptr; node->right = nullptr; node->isEnding = end;
-        return node;
+    // --- INITIALIZATION ---
+    // The compiled-in story (STORY_TABLE_H.h): nothing to build or free.
+    void init() {
+        seed(time(0));
+        start(STORY);
     }
 
-    void addItem(string n, string t, int e) {
-        Item* newItem = new Item;
-        newItem->name = n; newItem->type = t; newItem->effect = e; newItem->next = nullptr;
-        if (!inventoryHead) inventoryHead = newItem;
-        else {
-            Item* temp = inventoryHead;
-            while (temp->next) temp = temp->next;
-            temp->next = newItem;
-        }
-        currentMessage = "Found: " + n;
+    // Opening scene of a story the caller keeps alive (tools, reloads, benches).
+    void start(const Story& s) {
+        metricsCount(C_SESSIONS);
+        story = &s;
+        current = s.root();
+        rehashAll();
     }
 
-    Item* cloneInventory(Item* originalHead) {
-        if (!originalHead) return nullptr;
-        Item* newHead = new Item(*originalHead);
-        newHead->next = nullptr;
-        Item* currOrig = originalHead->next;
-        Item* currNew = newHead;
-        while (currOrig) {
-            currNew->next = new Item(*currOrig);
-            currNew->next->next = nullptr;
-            currNew = currNew->next;
-            currOrig = currOrig->next;
+    void maybeQueue(int percent, const GameEvent& e) {
+        if (rollPercent() < percent) {
+            eventQueue.push(e);
+            eventHash += eventKey(e);
         }
-        return newHead;
     }
 
-    void saveGame() {
-        GameState* newState = new GameState;
-        newState->savedWolf = player;
-        newState->savedNodeId = current->id;
-        newState->savedInventory = cloneInventory(inventoryHead);
-        newState->next = stackTop;
-        stackTop = newState;
+    void makeChoice(int choice) {
+        ScopedTimer timing(T_TURN);
+        drainInbox();
+        const StoryNode* wasAt = current;
+        Wolf before = player;
+        playTurn(*this, choice);
+        if (current != wasAt && current->isEnding) metricsCount(C_ENDINGS);
+        fieldHash ^= zobristKey(Z_NODE, wasAt->id) ^ zobristKey(Z_NODE, current->id)
+                   ^ wolfKey(before) ^ wolfKey(player);
+        if (listener) listener->turnPlayed(wasAt, choice);
     }
 
-    void undoGame() {
-        if (!stackTop) { currentMessage = "Nothing to undo!"; return; }
-        GameState* state = stackTop;
-        stackTop = stackTop->next;
-        player = state->savedWolf;
-        inventoryHead = state->savedInventory;
-        
-        // Manual search logic for your tree
-        if (state->savedNodeId == 1) current = root;
-        else if (state->savedNodeId == 2) current = root->left;
-        else if (state->savedNodeId == 3) current = root->right;
-        else if (state->savedNodeId == 4) current = root->left->left;
-        else if (state->savedNodeId == 5) current = root->left->right;
-        else if (state->savedNodeId == 6) current = root->right->left;
-        else if (state->savedNodeId == 7) current = root->right->right;
-        // ... (can add more ID checks here)
-
-        delete state;
-        currentMessage = "Time rewound!";
+    // --- TURN HOOKS (see playTurn) ---
+    void beforeTurn() {
+        if (undoable) saveGame();
     }
 
-    // --- INITIALIZATION (YOUR FULL 20+ NODES) ---
-    void init() {
-        srand(time(0));
-        root = createNode(1, "You stand at a fork. Blizzard approaching. LEFT: Cave. RIGHT: River.", "Enter Cave", "Follow River", false);
-        root->left = createNode(2, "Warm cave, smells of rot. Go deep or stay shallow?", "Go Deep", "Stay Shallow", false);
-        root->right = createNode(3, "River path. Brutal wind (-5 Energy). Thin ice ahead.", "Cross Ice", "Stay on Bank", false);
-        root->left->left = createNode(4, "Grizzly sleeping on bones. Backpack nearby.", "Sneak & Steal", "Attack Bear", false);
-        root->left->right = createNode(5, "Safe entrance. Strange scratches on the wall.", "Inspect Wall", "Just Sleep", false);
-        root->right->left = createNode(6, "Ice creaks. Deer carcass halfway across.", "Grab & Run", "Crawl Slowly", false);
-        root->right->right = createNode(7, "Hunter's trap line. Meat in a metal jaw.", "Try to take bait", "Ignore & Hunt", false);
-        root->left->left->left = createNode(8, "You grab the bag. It contains Medical Herbs! Run?", "Run out!", "Hide", false);
-        root->left->left->right = createNode(9, "The bear wakes up! It swipes at you.", "Dodge Left", "Bite Throat", false);
-        root->left->right->left = createNode(10, "Loose rock hides a tunnel to an underground lake.", "Drink Water", "Swim Across", false);
-        root->left->right->right = createNode(11, "You wake up hungrier than ever.", "Leave Cave", "Search Deeper", false);
-        root->right->left->left = createNode(12, "Ice SHATTERS! You fall in.", "Swim to Deer", "Climb Out", false);
-        root->right->left->right = createNode(13, "You reach the deer. Fresh meat!", "Eat Here", "Drag to Shore", false);
-        root->right->right->left = createNode(14, "SNAP! Trap closes on your tail (-30 Health).", "Chew leg free", "Howl for help", false);
-        root->right->right->right = createNode(15, "You smell a Wolf Pack nearby.", "Approach Pack", "Hide", false);
-        root->left->left->left->left = createNode(16, "You escape with loot! (Victory - Survivor)", "", "", true);
-        root->left->left->left->right = createNode(17, "The bear smells you. (Death)", "", "", true);
-        root->left->left->right->left = createNode(18, "Dodged! You flee bleeding. (Survival - Injured)", "", "", true);
-        root->left->left->right->right = createNode(19, "Bear is too strong. (Death)", "", "", true);
-        root->left->right->left->left = createNode(20, "Water is magical! Fully Healed! (Victory)", "", "", true);
-        root->left->right->left->right = createNode(21, "Something pulls you under... (Death)", "", "", true);
-
-        current = root;
+    void entered() {
+        for (const Pickup& p : storyPickups())
+            if (current->id == p.nodeId) addItem(p.name, p.type, p.effect);
     }
 
-    void makeChoice(int choice) {
-        if (eventActive) { eventActive = false; return; }
-        saveGame();
-        if (choice == 1 && current->left) { current = current->left; player.energy -= 10; }
-        else if (choice == 2 && current->right) { current = current->right; player.energy -= 5; }
-        player.hunger += 5;
-
-        // Inventory Triggers
-        if (current->id == 8) addItem("Medical Herbs", "Medical", 30);
-        if (current->id == 13) addItem("Fresh Venison", "Food", 40);
-        if (current->id == 4) addItem("Scraps", "Food", 10);
-
-        if ((rand() % 100) < 30) {
-            GameEvent e = {"Sudden Snowstorm! -10 Health", 2, -10};
-            eventQueue.push(e);
+    void rollEvents(Effect& turn, bool moved) {
+        if (!world && !replayWorld) {
+            maybeQueue(SNOWSTORM_CHANCE, SNOWSTORM);
+        } else {
+            WorldState w = replayWorld ? *replayWorld : world->read();
+            worldSeen = w;
+            maybeQueue(w.stormChance(), SNOWSTORM);
+            maybeQueue(w.hunterChance(), HUNTER_SHOT);
+            maybeQueue(w.preyChance(), PREY_CAUGHT);
+            if (moved && current->isEnding) maybeQueue(w.endingRiskChance(), LAST_STRETCH);
         }
         if (!eventQueue.empty()) {
             activeEvent = eventQueue.top();
             eventQueue.pop();
-            player.health += activeEvent.healthEffect;
+            eventHash -= eventKey(activeEvent);
+            turn += activeEvent.effect;
             eventActive = true;
-        }
-    }
-
-    ~GameEngine() {
-        while (inventoryHead) {
-            Item* temp = inventoryHead;
-            inventoryHead = inventoryHead->next;
-            delete temp;
+            metricsCount(C_EVENTS);
         }
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,90 @@
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include <string>
+#include <memory>
+#include "RULES_H.h"
+
+using namespace std;
+
+// --- ITEMS ---
+// What one point of an item's effect number does, by item type.
+struct ItemKind {
+    const char* type;
+    Stat stat;
+    int perPoint;
+};
+const ItemKind ITEM_KINDS[] = {
+    {"Food", STAT_HUNGER, -1},
+    {"Medical", STAT_HEALTH, 1},
+};
+
+inline Effect itemEffect(const string& type, int amount) {
+    for (const ItemKind& k : ITEM_KINDS)
+        if (type == k.type) return statEffect(k.stat, k.perPoint * amount);
+    return Effect();
+}
+
+struct Item {
+    string name;
+    string type;
+    int effect;
+    Effect onUse;                  // itemEffect(type, effect), resolved once when picked up
+    shared_ptr<const Item> next;   // the rest of the pack
+};
+
+// --- PACK ---
+// The pack is a persistent list, newest item first. Items never change once
+// in it, so a session, its undo history, snapshots and forks all share one
+// pack and a turn copies nothing. Adding an item allocates just that item
+// and shares the whole pack behind it; using one copies only the items in
+// front of it (those picked up later).
+inline shared_ptr<const Item> packWith(const shared_ptr<const Item>& pack, Item item) {
+    item.next = pack;
+    return make_shared<const Item>(move(item));
+}
+
+inline shared_ptr<const Item> packWithout(const shared_ptr<const Item>& pack, const Item* gone) {
+    if (!pack) return pack;
+    if (pack.get() == gone) return pack->next;
+    Item front = *pack;
+    front.next = packWithout(pack->next, gone);
+    return make_shared<const Item>(move(front));
+}
+
+inline bool samePack(const Item* a, const Item* b) {
+    for (; a && b && a != b; a = a->next.get(), b = b->next.get())
+        if (a->name != b->name || a->type != b->type || a->effect != b->effect) return false;
+    return a == b;   // the same shared tail, or both ended
+}
+
+// --- EVENTS ---
+struct GameEvent {
+    string description;
+    int priority;
+    Effect effect;
+};
+
+struct CompareEvent {
+    bool operator()(GameEvent const& e1, GameEvent const& e2) {
+        return e1.priority > e2.priority;
+    }
+};
+
+inline bool sameEvent(const GameEvent& a, const GameEvent& b) {
+    if (a.priority != b.priority || a.description != b.description) return false;
+    for (int s = 0; s < STAT_COUNT; s++)
+        if (a.effect.delta[s] != b.effect.delta[s]) return false;
+    return true;
+}
+
+// A fixed order for a set of pending events, so equal sets compare equal.
+inline bool eventBefore(const GameEvent& a, const GameEvent& b) {
+    if (a.priority != b.priority) return a.priority < b.priority;
+    if (a.description != b.description) return a.description < b.description;
+    for (int s = 0; s < STAT_COUNT; s++)
+        if (a.effect.delta[s] != b.effect.delta[s]) return a.effect.delta[s] < b.effect.delta[s];
+    return false;
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <vector>
+#include <memory>
+#include "TRANSPOSITION_H.h"
+
+using namespace std;
+
+// --- HISTORY TREE ---
+// Every state a session has recorded, as a tree: undo walks up, redo walks
+// back down the branch last taken, and a new choice after an undo opens a
+// sibling branch instead of throwing the old one away. States are interned
+// in a SnapshotStore, so branches (and sessions) that reach the same state
+// share one copy. GameEngine records a state before each turn and before
+// each undo; the calls that move return the snapshot to restore, and the
+// engine restores it through the story's id index.
+struct HistoryNode {
+    shared_ptr<const Snapshot> state;
+    int parent;
+    int turn;
+    vector<int> children;
+    int lastChild = -1;   // where redo goes
+    vector<int> jump;     // jump[k] = ancestor 2^k turns back
+};
+
+struct History {
+    vector<HistoryNode> nodes;
+    int at = -1;
+    int base = 0;       // turn of the root: 0 until compact() drops older turns
+    size_t bytes = 0;   // estimated heap footprint of the nodes; snapshots are interned and shared, so not counted
+
+    // Records a state as the next turn on the current branch. The state
+    // already there, or one this branch point already leads to, is reused.
+    void commit(shared_ptr<const Snapshot> state) {
+        if (at >= 0) {
+            if (nodes[at].state == state) return;
+            for (int c : nodes[at].children) {
+                if (nodes[c].state == state) { nodes[at].lastChild = c; at = c; return; }
+            }
+        }
+        at = add(move(state), at);
+    }
+
+    // Appends a node under parent (-1 = a root) and returns its index.
+    // Session files rebuild a tree with it, parents first.
+    int add(shared_ptr<const Snapshot> state, int parent) {
+        HistoryNode n;
+        n.state = move(state);
+        n.parent = parent;
+        n.turn = parent < 0 ? base : nodes[parent].turn + 1;
+        if (parent >= 0) {
+            n.jump.push_back(parent);
+            for (int k = 0; k < (int)n.jump.size() && k < (int)nodes[n.jump[k]].jump.size(); k++)
+                n.jump.push_back(nodes[n.jump[k]].jump[k]);
+        }
+        bytes += sizeof(HistoryNode) + n.jump.size() * sizeof(int) + sizeof(int);
+        nodes.push_back(move(n));
+        int id = (int)nodes.size() - 1;
+        if (parent >= 0) {
+            nodes[parent].children.push_back(id);
+            nodes[parent].lastChild = id;
+        }
+        return id;
+    }
+
+    // Each returns the snapshot to restore, or null (and stays put) if
+    // there is nowhere to go.
+    const Snapshot* undo() {
+        if (at < 0 || nodes[at].parent < 0) return nullptr;
+        return moveTo(nodes[at].parent);
+    }
+
+    const Snapshot* redo() {
+        if (at < 0 || nodes[at].lastChild < 0) return nullptr;
+        return moveTo(nodes[at].lastChild);
+    }
+
+    // Other branches taken from the same earlier turn as this one.
+    int branchCount() const {
+        if (at < 0 || nodes[at].parent < 0) return 1;
+        return (int)nodes[nodes[at].parent].children.size();
+    }
+
+    const Snapshot* switchBranch(int index) {
+        if (at < 0 || nodes[at].parent < 0) return nullptr;
+        HistoryNode& p = nodes[nodes[at].parent];
+        if (index < 0 || index >= (int)p.children.size()) return nullptr;
+        p.lastChild = p.children[index];
+        return moveTo(p.children[index]);
+    }
+
+    // Back to an earlier turn of the current branch in O(log turns): one
+    // jump per set bit of the distance.
+    const Snapshot* jumpTo(int turn) {
+        if (at < 0 || turn < base || turn > nodes[at].turn) return nullptr;
+        int n = at;
+        int back = nodes[at].turn - turn;
+        for (int k = 0; back; k++, back >>= 1)
+            if (back & 1) n = nodes[n].jump[k];
+        return moveTo(n);
+    }
+
+    int turn() const { return at < 0 ? 0 : nodes[at].turn; }
+
+    // Forgets everything more than `keep` turns before the current one: the
+    // ancestor that far back becomes the root, and what descends from it
+    // stays (this branch and every branch opened since). Turn numbers do
+    // not change, so undo and jump stop at that turn instead of 0.
+    void compact(int keep) {
+        if (at < 0 || nodes[at].turn - base <= keep) return;
+        int root = at;
+        for (int k = 0, back = keep; back; k++, back >>= 1)
+            if (back & 1) root = nodes[root].jump[k];
+
+        vector<int> renumber(nodes.size(), -1);   // old index -> new, -1 if dropped
+        History kept;
+        kept.base = nodes[root].turn;
+        for (int i = root; i < (int)nodes.size(); i++) {   // parents come before children
+            int p = i == root ? -1 : nodes[i].parent;
+            if (i != root && (p < root || renumber[p] < 0)) continue;
+            renumber[i] = kept.add(nodes[i].state, p < 0 ? -1 : renumber[p]);
+        }
+        for (int i = root; i < (int)nodes.size(); i++)   // add() left each parent at its newest child
+            if (renumber[i] >= 0 && nodes[i].lastChild >= 0)
+                kept.nodes[renumber[i]].lastChild = renumber[nodes[i].lastChild];
+        kept.at = renumber[at];
+        *this = move(kept);
+    }
+
+private:
+    // Every ancestor's lastChild already points down toward the current turn
+    // (commit, redo and switchBranch keep it so), so moving never walks the path.
+    const Snapshot* moveTo(int n) {
+        at = n;
+        return nodes[n].state.get();
+    }
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef INBOX_H
+#define INBOX_H
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// --- MPSC INBOX ---
+// Bounded ring after Dmitry Vyukov's queue: every cell carries a sequence
+// number saying whose turn it is, so producers claim a cell with one CAS on
+// head and never wait on each other or on the consumer. Only the owning
+// session drains it, so the consumer side needs no atomics of its own.
+// tryPush fails instead of blocking when the ring is full.
+template <class T>
+struct MpscInbox {
+    struct Cell {
+        atomic<size_t> seq;
+        T value;
+    };
+
+    explicit MpscInbox(size_t capacity = 64) {
+        size_t n = 2;
+        while (n < capacity) n <<= 1;
+        mask = n - 1;
+        cells = vector<Cell>(n);
+        for (size_t i = 0; i < n; i++) cells[i].seq.store(i, memory_order_relaxed);
+    }
+
+    MpscInbox(const MpscInbox&) = delete;
+    MpscInbox& operator=(const MpscInbox&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    // Any thread.
+    bool tryPush(const T& v) {
+        size_t pos = head.load(memory_order_relaxed);
+        Cell* c;
+        while (true) {
+            c = &cells[pos & mask];
+            size_t seq = c->seq.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = head.load(memory_order_relaxed);
+            }
+        }
+        c->value = v;
+        c->seq.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    // Owner only. Hands every published entry to f, oldest first; stops at
+    // the first cell a producer has claimed but not yet filled.
+    template <class F>
+    size_t drain(F f) {
+        size_t n = 0;
+        while (true) {
+            Cell& c = cells[tail & mask];
+            if (c.seq.load(memory_order_acquire) != tail + 1) return n;
+            f(move(c.value));
+            c.seq.store(tail + mask + 1, memory_order_release);
+            tail++;
+            n++;
+        }
+    }
+
+private:
+    vector<Cell> cells;
+    size_t mask;
+    alignas(64) atomic<size_t> head{0};
+    alignas(64) size_t tail = 0;
+};
+
+#endif
@@ -0,0 +1,34 @@
+// Kiosk build: the story is compiled in (STORY_TABLE_H.h, see StoryCodegen.cpp)
+// and only RULES_H.h comes with it, so nothing runs or is allocated before main.
+// Build: g++ -O2 -std=c++17 Kiosk.cpp -o kiosk
+// Run:   ./kiosk
+#include <cstdio>
+#include <ctime>
+#include "STORY_TABLE_H.h"
+
+using namespace std;
+
+int main() {
+    StaticStory game(STORY);
+    game.init((uint64_t)time(0));
+    while (true) {
+        const StoryNode& s = game.scene();
+        printf("\n%.*s\n", (int)s.description.size(), s.description.data());
+        printf("Health %d  Hunger %d  Energy %d\n", game.player.health, game.player.hunger, game.player.energy);
+        if (game.eventActive) printf("%s\n", SNOWSTORM_TEXT);
+        if (game.isEnding()) break;
+        if (game.player.health <= 0 || game.player.hunger >= 100 || game.player.energy <= 0) {   // isDeath()
+            printf("Your body gives out in the snow.\n");
+            break;
+        }
+        if (!game.eventActive)
+            printf("1) %.*s\n2) %.*s\n> ", (int)s.choiceA.size(), s.choiceA.data(), (int)s.choiceB.size(), s.choiceB.data());
+        else printf("Press Enter to weather the storm.\n> ");
+
+        int c = getchar();
+        if (c == EOF) break;
+        for (int rest = c; rest != '\n' && rest != EOF;) rest = getchar();
+        game.choose(c - '0');
+    }
+    return 0;
+}
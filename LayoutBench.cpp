@@ -0,0 +1,177 @@
+// Traversal benchmark: a heap graph of pointer nodes vs packed 16-byte layouts.
+// Build: g++ -O2 -std=c++17 LayoutBench.cpp -o layout_bench
+// Run:   ./layout_bench [nodes] [hops] [seed]   (story from STORY_GEN_H.h defaults)
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "STORY_LAYOUT_H.h"
+#include "STORY_GEN_H.h"
+
+using namespace std;
+
+// ---------------- CACHE MISS COUNTER ----------------
+struct MissCounter {
+    int fd = -1;
+
+    MissCounter() {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    ~MissCounter() { if (fd >= 0) close(fd); }
+
+    void start() {
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    long long stop() {
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long v = 0;
+        if (read(fd, &v, sizeof(v)) != sizeof(v)) return -1;
+        return v;
+    }
+};
+
+// ---------------- RANDOM STORY ----------------
+struct Rng {
+    uint64_t s;
+    uint64_t next() { s ^= s << 13; s ^= s >> 7; s ^= s << 17; return s; }
+};
+
+// The baseline: one heap node per scene with its text inline and choices
+// as pointers. Nodes are allocated in shuffled order so the graph is
+// scattered over the heap the way a long-lived story would be.
+struct PointerNode {
+    int id;
+    string description;
+    string choiceA;
+    string choiceB;
+    PointerNode* left;
+    PointerNode* right;
+    bool isEnding;
+};
+
+PointerNode* buildPointers(const GenStory& g, vector<PointerNode*>& all) {
+    Rng rng{88172645463325252ULL};
+    vector<int> order(g.size());
+    for (int i = 0; i < g.size(); i++) order[i] = i + 1;
+    for (int i = g.size() - 1; i > 0; i--) swap(order[i], order[rng.next() % (i + 1)]);
+    all.assign(g.size() + 1, nullptr);
+    for (int id : order)
+        all[id] = new PointerNode{id, genTitle(id) + "\n" + genLine(id), g.ending[id] ? "" : "Go on",
+                                  g.ending[id] ? "" : "Turn back", nullptr, nullptr, (bool)g.ending[id]};
+    for (int id = 1; id <= g.size(); id++) {
+        all[id]->left = g.left[id] ? all[g.left[id]] : nullptr;
+        all[id]->right = g.right[id] ? all[g.right[id]] : nullptr;
+    }
+    return all[1];
+}
+
+// ---------------- WALKS ----------------
+// An ending restarts the walk at a random scene, as if another session were
+// picking up somewhere else in the story.
+long long walkPointers(const vector<PointerNode*>& all, long long hops, uint64_t seed) {
+    Rng rng{seed};
+    int n = (int)all.size() - 1;
+    PointerNode* node = all[1];
+    long long sum = 0;
+    for (long long h = 0; h < hops; h++) {
+        uint64_t r = rng.next();
+        node = (r & 1) ? node->left : node->right;
+        while (node->isEnding) node = all[1 + (r = rng.next()) % n];
+        sum += node->id;
+    }
+    return sum;
+}
+
+long long walkPacked(const StoryLayout& layout, const vector<int>& slotById, long long hops, uint64_t seed) {
+    Rng rng{seed};
+    const PackedNode* nodes = layout.nodes.data();
+    int n = (int)slotById.size() - 1;
+    int slot = 0;
+    long long sum = 0;
+    for (long long h = 0; h < hops; h++) {
+        uint64_t r = rng.next();
+        slot = (r & 1) ? nodes[slot].left : nodes[slot].right;
+        while (nodes[slot].flags & NODE_ENDING) slot = slotById[1 + (r = rng.next()) % n];
+        sum += nodes[slot].id;
+    }
+    return sum;
+}
+
+template <class F>
+void report(const string& name, long long hops, F walk) {
+    MissCounter misses;
+    misses.start();
+    auto t0 = chrono::steady_clock::now();
+    long long sum = walk();
+    auto t1 = chrono::steady_clock::now();
+    long long m = misses.stop();
+    double ns = chrono::duration<double, nano>(t1 - t0).count() / hops;
+    cout << name << ": " << ns << " ns/hop";
+    if (m >= 0) cout << ", " << (double)m / hops << " cache misses/hop";
+    else cout << ", cache misses n/a (perf_event_open unavailable)";
+    cout << "  [checksum " << sum << "]" << endl;
+}
+
+// ---------------- MAIN ----------------
+int main(int argc, char** argv) {
+    GenParams params;
+    params.nodes = argc > 1 ? atoi(argv[1]) : 1 << 20;
+    long long hops = argc > 2 ? atoll(argv[2]) : 20000000;
+    params.seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+    params.endings = 0.02;   // long walks between restarts
+    int n = params.nodes;
+    const uint64_t seed = 0x9E3779B97F4A7C15ULL;
+
+    GenStory generated = generateStory(params);
+    vector<PointerNode*> all;
+    PointerNode* root = buildPointers(generated, all);
+    OwnedStory story = buildStory(generated);
+
+    StoryLayout bfs;
+    bfs.buildBfs(story.story);
+
+    // Profile part of the walk to order the frequency layout.
+    vector<uint64_t> visits(n + 1, 0);
+    {
+        Rng rng{seed};
+        PointerNode* cur = root;
+        for (long long h = 0; h < hops / 4; h++) {
+            uint64_t r = rng.next();
+            cur = (r & 1) ? cur->left : cur->right;
+            while (cur->isEnding) cur = all[1 + (r = rng.next()) % n];
+            visits[cur->id]++;
+        }
+    }
+    StoryLayout freq;
+    freq.buildByFrequency(story.story, visits);
+
+    auto slots = [&](const StoryLayout& layout) {
+        vector<int> slotById(n + 1, 0);
+        for (int id = 1; id <= n; id++) slotById[id] = layout.find(id);
+        return slotById;
+    };
+    vector<int> bfsSlots = slots(bfs), freqSlots = slots(freq);
+
+    cout << n << " scenes (" << bfs.nodes.size() << " reachable), " << hops << " hops" << endl;
+    report("heap pointers      ", hops, [&] { return walkPointers(all, hops, seed); });
+    report("packed, BFS order  ", hops, [&] { return walkPacked(bfs, bfsSlots, hops, seed); });
+    report("packed, by visits  ", hops, [&] { return walkPacked(freq, freqSlots, hops, seed); });
+
+    for (PointerNode* s : all) delete s;   // all[0] is unused (nullptr)
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Plays GameEngine sessions on a lazily loaded story (STORY_TEXT_H.h): only
+// topology is resident, and each session reads a scene's text from the
+// mapped scenarios.txt when it is shown. On the shipped story files every
+// scene shown is also checked against the compiled-in table.
+// Build: g++ -O2 -std=c++17 LazyPlay.cpp -o lazy_play
+// Run:   ./lazy_play [story_edges.txt] [scenarios.txt] [sessions]
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <sys/resource.h>
+#include "GAME_ENGINE_H.h"
+#include "STORY_TEXT_H.h"
+#include "SOLVER_H.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    string edges = argc > 1 ? argv[1] : "story_edges.txt";
+    string scenes = argc > 2 ? argv[2] : "scenarios.txt";
+    int sessions = argc > 3 ? atoi(argv[3]) : 1000;
+    bool shipped = argc < 3;   // the files STORY_TABLE_H.h was generated from
+
+    LazyStory lazy;
+    if (!lazy.open(edges, scenes)) { cerr << "cannot open " << edges << " / " << scenes << endl; return 1; }
+
+    long long turns = 0, shown = 0, endings = 0, mismatches = 0;
+    size_t mostText = 0;
+    for (int s = 0; s < sessions; s++) {
+        GameEngine game;
+        game.start(lazy.story());
+        game.seed(zobristMix((uint64_t)s + 1));
+        LazyText text(lazy);
+        for (int t = 0; t < 200; t++) {
+            const ColdText& scene = text.show(game.current);
+            shown++;
+            mostText = max(mostText, text.bytes());
+            if (shipped) {
+                const StoryNode* compiled = STORY.find(game.current->id);
+                if (!compiled || compiled->description != scene.description || compiled->choiceA != scene.choiceA ||
+                    compiled->choiceB != scene.choiceB) mismatches++;
+            }
+            if (game.current->isEnding) { endings++; break; }
+            if (isDeath(game.player.health, game.player.hunger, game.player.energy)) break;
+            if (game.player.hunger >= 60) { if (!game.useItem("Fresh Venison")) game.useItem("Scraps"); }
+            if (game.player.health <= 50) game.useItem("Medical Herbs");
+            if (game.rollPercent() < 10) game.undoGame();
+            else game.makeChoice(1 + game.rollPercent() % 2);
+            turns++;
+        }
+    }
+
+    cout << sessions << " sessions, " << turns << " turns, " << shown << " scenes shown, " << endings << " endings\n"
+         << lazy.story().count << " scenes, " << lazy.index.size << " bytes of text on disk, at most "
+         << mostText << " bytes resident per session\n";
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) cout << "peak RSS " << usage.ru_maxrss / 1024 << " MB\n";
+    if (shipped) cout << (mismatches ? to_string(mismatches) + " scenes differ from the compiled table" : string("every scene matches the compiled table")) << endl;
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,158 @@
+// Live-reload check (STORY_RELOAD_H.h): edits a copy of the story files
+// under a running session, the way a writer would, and checks what the
+// session sees after each save.
+// Build: g++ -O2 -std=c++17 -pthread LiveReload.cpp -o live_reload
+// Run:   ./live_reload [story_edges.txt] [scenarios.txt]
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include "STORY_RELOAD_H.h"
+
+using namespace std;
+
+int failures = 0;
+
+void check(bool ok, const string& what) {
+    cout << (ok ? "ok    " : "FAIL  ") << what << endl;
+    if (!ok) failures++;
+}
+
+bool readFile(const string& path, string& out) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) return false;
+    ostringstream s;
+    s << file.rdbuf();
+    out = s.str();
+    return true;
+}
+
+bool writeFile(const string& path, const string& text) {
+    ofstream file(path, ios::binary | ios::trunc);
+    file << text;
+    return (bool)file;
+}
+
+// Editors save to a temporary file and rename it over the original.
+bool saveByRename(const string& path, const string& text) {
+    return writeFile(path + ".swp", text) && rename((path + ".swp").c_str(), path.c_str()) == 0;
+}
+
+// Waits up to three seconds for the watcher to publish a version that passes.
+template <class F>
+bool waitFor(StoryLibrary& library, F ready) {
+    for (int i = 0; i < 300; i++) {
+        shared_ptr<const StoryVersion> v = library.current();
+        if (v && ready(*v)) return true;
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    return false;
+}
+
+// A pending event takes a turn of its own; clear it so the choice moves.
+void move(LiveSession& s, int choice) {
+    while (s.game.eventActive) s.makeChoice(choice);
+    s.makeChoice(choice);
+}
+
+string sceneText(const LiveSession& s) { return string(s.game.current->description); }
+
+int main(int argc, char** argv) {
+    string edgesSource = argc > 1 ? argv[1] : "story_edges.txt";
+    string scenesSource = argc > 2 ? argv[2] : "scenarios.txt";
+    string edgesText, scenesText;
+    if (!readFile(edgesSource, edgesText) || !readFile(scenesSource, scenesText)) {
+        cerr << "cannot read " << edgesSource << " / " << scenesSource << endl;
+        return 1;
+    }
+    char dirName[] = "/tmp/live_reload.XXXXXX";
+    if (!mkdtemp(dirName)) { cerr << "cannot make a scratch directory" << endl; return 1; }
+    string dir = dirName, edges = dir + "/story_edges.txt", scenes = dir + "/scenarios.txt";
+    writeFile(edges, edgesText);
+    writeFile(scenes, scenesText);
+
+    StoryLibrary library(edges, scenes);
+    LiveSession early(library);
+    check(!early.makeChoice(1), "a session with nothing published takes no turn");
+
+    ReloadStats first = library.reload();
+    check(first.published && first.parsed == library.current()->story().count, "first load parses every scene");
+    StoryWatcher watcher(library);
+    if (!watcher.start(dir)) { cerr << "cannot watch " << dir << endl; return 1; }
+
+    LiveSession session(library);
+    session.game.seed(1);
+    check(session.game.fieldHash != 0, "a new session hashes its opening state");
+    move(session, 1);
+    int at = session.game.current->id;
+    cout << "session at scene " << at << endl;
+
+    // 1. Retitle the session's scene. Only that scene is parsed again.
+    shared_ptr<const StoryVersion> before = library.current();
+    string heading = "SCENE " + to_string(at) + ": ";
+    size_t title = scenesText.find(heading);
+    if (title == string::npos) { cerr << "scene " << at << " has no heading in " << scenesSource << endl; return 1; }
+    scenesText.insert(title + heading.size(), "Edited ");
+    check(saveByRename(scenes, scenesText) &&
+          waitFor(library, [&](const StoryVersion& v) { return v.version > before->version; }), "retitled scene is published");
+    shared_ptr<const StoryVersion> after = library.current();
+    early.makeChoice(1);   // the early session joins the story too
+    session.makeChoice(0);   // no such choice: migrates without moving
+    check(session.game.current->id == at && sceneText(session).find("Edited ") != string::npos,
+          "session sees the new title on its next turn");
+    int shared = 0;
+    for (int slot = 0; slot < after->story().count; slot++)
+        if (after->scenes.text[slot] == before->scenes.text[before->story().slotOf(before->story().find(after->story().nodes[slot].id))])
+            shared++;
+    check(shared == after->story().count - 1, "every other scene shares the old version's text (" + to_string(shared) + ")");
+    check(early.pinned && early.game.current && early.game.fieldHash != 0, "the early session joined and hashed its state");
+
+    // 2. A new ending behind choice A, written in place: edges, then text.
+    int fresh = after->story().idLimit;
+    const StoryNode* here = session.game.current;
+    bool canBranch = !here->isEnding && here->left >= 0;
+    string originalEdges = edgesText;
+    if (canBranch) {
+        string line = to_string(at) + " " + to_string(after->story().nodes[here->left].id) + " ";
+        size_t edge = edgesText.find("\n" + line);
+        if (edge == string::npos) { cerr << "scene " << at << " has no edge line" << endl; return 1; }
+        size_t end = edgesText.find(' ', edge + 1 + to_string(at).size() + 1);
+        edgesText.replace(edge + 1, end - edge - 1, to_string(at) + " " + to_string(fresh));
+        edgesText += to_string(fresh) + " 0 0\n";
+        scenesText += "\nENDING " + to_string(fresh) + ": The Quiet Den\n\nA den that was not there a moment ago.\n";
+        writeFile(edges, edgesText);
+        writeFile(scenes, scenesText);
+        // The two saves may land as one version or two; wait for the one with both.
+        check(waitFor(library, [&](const StoryVersion& v) {
+                  const StoryNode* n = v.story().find(fresh);
+                  return n && n->isEnding && n->description.find("The Quiet Den") != string_view::npos;
+              }), "new ending is published");
+        move(session, 1);
+        check(session.game.current->id == fresh && sceneText(session).find("The Quiet Den") != string::npos,
+              "choice A now leads to the new ending");
+    } else {
+        check(false, "scene " + to_string(at) + " has a choice A to redirect");
+    }
+
+    // 3. Delete that ending again, edges only: the session goes back to the
+    // opening scene, and the unchanged scenarios file is not read again.
+    if (canBranch) {
+        shared_ptr<const StoryVersion> withEnding = library.current();
+        check(saveByRename(edges, originalEdges) &&
+              waitFor(library, [&](const StoryVersion& v) { return !v.story().find(fresh); }), "deleted ending is published");
+        check(library.current()->scenarios == withEnding->scenarios, "scenarios.txt was not read for an edges-only save");
+        session.makeChoice(0);
+        check(session.game.current == session.game.story->root(), "a session on a deleted scene restarts at the opening scene");
+    }
+
+    watcher.stop();
+    remove(edges.c_str());
+    remove(scenes.c_str());
+    remove(dir.c_str());
+    cout << (failures ? to_string(failures) + " failed" : string("all checks passed")) << endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,294 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using namespace std;
+
+// --- METRICS ---
+// Every thread records into its own shard: plain relaxed loads and stores,
+// no locks and no shared cache lines on the hot path. A scrape walks all
+// shards and merges them; it may miss a sample in flight, never corrupts one.
+// When a thread exits, its shard is folded into one retired total and freed,
+// so short-lived threads do not leave ~46 KB each behind.
+enum Timer { T_TURN, T_SAVE, T_UNDO, T_LOAD, T_SAVE_FILE, TIMER_COUNT };
+enum Counter { C_SESSIONS, C_ALLOCS, C_EVENTS, C_ENDINGS, COUNTER_COUNT };
+
+const char* const TIMER_NAMES[TIMER_COUNT] = {"wolf_turn", "wolf_save", "wolf_undo", "wolf_load", "wolf_save_file"};
+const char* const TIMER_HELP[TIMER_COUNT] = {
+    "makeChoice latency", "saveGame (undo snapshot) latency", "undoGame latency",
+    "story load/reload latency", "savegame.txt write latency"};
+const char* const COUNTER_NAMES[COUNTER_COUNT] = {
+    "wolf_sessions_total", "wolf_allocations_total", "wolf_events_fired_total", "wolf_endings_reached_total"};
+const char* const COUNTER_HELP[COUNTER_COUNT] = {
+    "sessions started", "engine heap allocations (new save states, items)", "events fired", "endings reached"};
+
+// --- HDR HISTOGRAM ---
+// Log-linear buckets over nanoseconds: 32 linear steps per power of two,
+// so any recorded value is within ~3% of its bucket, from 1 ns to ~18 min.
+const int HDR_SUB_BITS = 5;
+const int HDR_SUB = 1 << HDR_SUB_BITS;
+const int HDR_MAX_BITS = 40;
+const int HDR_BUCKETS = (HDR_MAX_BITS - HDR_SUB_BITS + 1) * HDR_SUB;
+
+inline int hdrBucket(uint64_t v) {
+    if (v < (uint64_t)HDR_SUB) return (int)v;
+    int top = 63 - __builtin_clzll(v);
+    if (top >= HDR_MAX_BITS) return HDR_BUCKETS - 1;
+    int shift = top - HDR_SUB_BITS;
+    return (shift + 1) * HDR_SUB + (int)((v >> shift) - HDR_SUB);
+}
+
+inline uint64_t hdrBucketMid(int b) {
+    if (b < HDR_SUB) return b;
+    int shift = b / HDR_SUB - 1;
+    uint64_t low = ((uint64_t)(HDR_SUB + b % HDR_SUB)) << shift;
+    return low + (1ULL << shift) / 2;
+}
+
+struct MetricsShard {
+    atomic<uint64_t> buckets[TIMER_COUNT][HDR_BUCKETS];
+    atomic<uint64_t> sumNs[TIMER_COUNT];
+    atomic<uint64_t> counters[COUNTER_COUNT];
+
+    MetricsShard() {
+        for (auto& t : buckets)
+            for (auto& b : t) b.store(0, memory_order_relaxed);
+        for (auto& s : sumNs) s.store(0, memory_order_relaxed);
+        for (auto& c : counters) c.store(0, memory_order_relaxed);
+    }
+
+    // Only the owning thread writes, so no read-modify-write is needed.
+    static void bump(atomic<uint64_t>& a, uint64_t by) {
+        a.store(a.load(memory_order_relaxed) + by, memory_order_relaxed);
+    }
+};
+
+struct MetricsRegistry {
+    mutex lock;
+    vector<MetricsShard*> shards;   // one per live thread that has recorded
+    MetricsShard retired;           // everything threads recorded before they exited
+
+    // Never destroyed, so a thread may exit (and retire) at any time.
+    static MetricsRegistry& instance() {
+        static MetricsRegistry* r = new MetricsRegistry;
+        return *r;
+    }
+
+    // The hot path only checks a plain pointer; the exit hook is armed once.
+    static MetricsShard& local() {
+        static thread_local MetricsShard* shard = nullptr;
+        if (!shard) shard = instance().join(&shard);
+        return *shard;
+    }
+
+    // Calls f(shard) for the retired total and every live shard, under lock.
+    template <class F>
+    void forEach(F f) {
+        lock_guard<mutex> guard(lock);
+        f(retired);
+        for (MetricsShard* s : shards) f(*s);
+    }
+
+private:
+    struct Leaver {
+        MetricsShard** slot = nullptr;
+        ~Leaver() {
+            if (slot && *slot) instance().leave(*slot);
+            if (slot) *slot = nullptr;
+        }
+    };
+
+    MetricsShard* join(MetricsShard** slot) {
+        static thread_local Leaver leaver;
+        MetricsShard* s = new MetricsShard;
+        {
+            lock_guard<mutex> guard(lock);
+            shards.push_back(s);
+        }
+        leaver.slot = slot;
+        return s;
+    }
+
+    void leave(MetricsShard* s) {
+        {
+            lock_guard<mutex> guard(lock);
+            for (int t = 0; t < TIMER_COUNT; t++) {
+                for (int b = 0; b < HDR_BUCKETS; b++)
+                    MetricsShard::bump(retired.buckets[t][b], s->buckets[t][b].load(memory_order_relaxed));
+                MetricsShard::bump(retired.sumNs[t], s->sumNs[t].load(memory_order_relaxed));
+            }
+            for (int c = 0; c < COUNTER_COUNT; c++)
+                MetricsShard::bump(retired.counters[c], s->counters[c].load(memory_order_relaxed));
+            shards.erase(find(shards.begin(), shards.end(), s));
+        }
+        delete s;
+    }
+};
+
+inline void metricsTime(Timer t, uint64_t ns) {
+    MetricsShard& s = MetricsRegistry::local();
+    MetricsShard::bump(s.buckets[t][hdrBucket(ns)], 1);
+    MetricsShard::bump(s.sumNs[t], ns);
+}
+
+inline void metricsCount(Counter c, uint64_t n = 1) {
+    MetricsShard::bump(MetricsRegistry::local().counters[c], n);
+}
+
+// Times the enclosing scope.
+struct ScopedTimer {
+    Timer timer;
+    chrono::steady_clock::time_point start;
+
+    explicit ScopedTimer(Timer t) : timer(t), start(chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        metricsTime(timer, (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    }
+};
+
+// --- SCRAPE ---
+struct MergedTimer {
+    vector<uint64_t> buckets = vector<uint64_t>(HDR_BUCKETS, 0);
+    uint64_t count = 0, sumNs = 0;
+
+    double quantileSeconds(double q) const {
+        if (!count) return 0;
+        uint64_t want = (uint64_t)(q * count), seen = 0;
+        for (int b = 0; b < HDR_BUCKETS; b++) {
+            seen += buckets[b];
+            if (seen > want) return hdrBucketMid(b) * 1e-9;
+        }
+        return hdrBucketMid(HDR_BUCKETS - 1) * 1e-9;
+    }
+};
+
+// Prometheus text exposition format: a summary per timer, then counters.
+inline string metricsText() {
+    MergedTimer timers[TIMER_COUNT];
+    uint64_t counters[COUNTER_COUNT] = {};
+    MetricsRegistry::instance().forEach([&](const MetricsShard& s) {
+        for (int t = 0; t < TIMER_COUNT; t++) {
+            for (int b = 0; b < HDR_BUCKETS; b++) {
+                uint64_t n = s.buckets[t][b].load(memory_order_relaxed);
+                timers[t].buckets[b] += n;
+                timers[t].count += n;
+            }
+            timers[t].sumNs += s.sumNs[t].load(memory_order_relaxed);
+        }
+        for (int c = 0; c < COUNTER_COUNT; c++) counters[c] += s.counters[c].load(memory_order_relaxed);
+    });
+
+    string out;
+    char line[256];
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    for (int t = 0; t < TIMER_COUNT; t++) {
+        snprintf(line, sizeof line, "# HELP %s_seconds %s\n# TYPE %s_seconds summary\n", TIMER_NAMES[t], TIMER_HELP[t], TIMER_NAMES[t]);
+        out += line;
+        for (double q : quantiles) {
+            snprintf(line, sizeof line, "%s_seconds{quantile=\"%g\"} %.9g\n", TIMER_NAMES[t], q, timers[t].quantileSeconds(q));
+            out += line;
+        }
+        snprintf(line, sizeof line, "%s_seconds_sum %.9g\n%s_seconds_count %llu\n", TIMER_NAMES[t], timers[t].sumNs * 1e-9,
+                 TIMER_NAMES[t], (unsigned long long)timers[t].count);
+        out += line;
+    }
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        snprintf(line, sizeof line, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", COUNTER_NAMES[c], COUNTER_HELP[c],
+                 COUNTER_NAMES[c], COUNTER_NAMES[c], (unsigned long long)counters[c]);
+        out += line;
+    }
+    return out;
+}
+
+// For node_exporter's textfile collector: written aside, then renamed over.
+inline bool metricsWriteFile(const string& path) {
+    string tmp = path + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f) return false;
+    string text = metricsText();
+    bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+    ok = fclose(f) == 0 && ok;
+    return ok && rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+// Answers every connection on 127.0.0.1:port with the current dump, as a
+// minimal HTTP response so Prometheus can scrape it directly.
+struct MetricsServer {
+    int fd = -1;
+    atomic<bool> stopping{false};
+    thread worker;
+
+    bool start(int port) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return false;
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof yes);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof addr);
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(fd, (sockaddr*)&addr, sizeof addr) < 0 || listen(fd, 8) < 0) {
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        worker = thread([this] { serve(); });
+        return true;
+    }
+
+    ~MetricsServer() {
+        stopping = true;
+        if (fd >= 0) shutdown(fd, SHUT_RDWR);
+        if (worker.joinable()) worker.join();
+        if (fd >= 0) close(fd);
+    }
+
+private:
+    // A failing accept (out of descriptors, say) backs off from 1 ms up to
+    // a second instead of spinning; a connection resets the wait.
+    void serve() {
+        int waitMs = 0;
+        while (!stopping) {
+            int client = accept(fd, nullptr, nullptr);
+            if (client < 0) {
+                if (stopping) break;
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                waitMs = min(1000, max(1, waitMs * 2));
+                this_thread::sleep_for(chrono::milliseconds(waitMs));
+                continue;
+            }
+            waitMs = 0;
+            char request[1024];
+            ssize_t ignored = recv(client, request, sizeof request, MSG_DONTWAIT);
+            (void)ignored;
+            string body = metricsText();
+            string reply = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                           to_string(body.size()) + "\r\n\r\n" + body;
+            for (size_t done = 0; done < reply.size();) {
+                ssize_t n = send(client, reply.data() + done, reply.size() - done, MSG_NOSIGNAL);
+                if (n <= 0) break;
+                done += n;
+            }
+            close(client);
+        }
+    }
+};
+
+#endif
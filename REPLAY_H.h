@@ -0,0 +1,248 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <cstdint>
+#include <cstring>
+#include "GAME_ENGINE_H.h"
+
+using namespace std;
+
+// --- REPLAY FILES ---
+// "WOLFRPL1", u64 seed, then one record per input:
+//   u8 op (1 = choice, 2 = undo, 3 = use item, 4 = redo, 5 = jump to turn,
+//   6 = switch branch, 7 = choice with outside input), payload, u32 checksum
+// choice payload: u8 choice; use payload: u8 length + item name bytes;
+// jump and branch payload: u32 turn / branch index. Undo and redo have none.
+// A choice that took events from the inbox or read the shared world is
+// op 7 instead, so it replays without either: u8 choice, u32 event count,
+// per event u16 length + text, i32 priority, i32 per stat; then u8 1 and
+// i32 season, storm front, prey density, hunter activity if the turn read
+// the world, else u8 0.
+// The checksum rolls the engine's state hash over every input so far, so
+// the first mismatch is the first turn that played out differently.
+const char REPLAY_MAGIC[9] = "WOLFRPL1";
+
+enum ReplayOp : uint8_t {
+    REPLAY_CHOICE = 1,
+    REPLAY_UNDO = 2,
+    REPLAY_USE = 3,
+    REPLAY_REDO = 4,
+    REPLAY_JUMP = 5,
+    REPLAY_BRANCH = 6,
+    REPLAY_TURN = 7,
+};
+
+inline uint64_t rollChecksum(uint64_t roll, const GameEngine& g) {
+    return zobristMix(roll ^ g.stateHash());
+}
+
+// Wraps a live session: every input goes to the engine and into the log.
+struct ReplayRecorder {
+    GameEngine& game;
+    vector<uint8_t> bytes;
+    uint64_t roll = 0;
+
+    vector<GameEvent> drained;   // by the turn being recorded
+
+    ReplayRecorder(GameEngine& g, uint64_t seed) : game(g) {
+        game.seed(seed);
+        game.drainLog = &drained;
+        bytes.assign(REPLAY_MAGIC, REPLAY_MAGIC + 8);
+        put(seed, 8);
+    }
+    ~ReplayRecorder() { game.drainLog = nullptr; }
+
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    void makeChoice(int choice) {
+        bool readsWorld = game.world && !game.eventActive;   // a dismissal rolls nothing
+        drained.clear();
+        game.makeChoice(choice);
+        if (drained.empty() && !readsWorld) {
+            bytes.push_back(REPLAY_CHOICE);
+            bytes.push_back((uint8_t)choice);
+        } else {
+            bytes.push_back(REPLAY_TURN);
+            bytes.push_back((uint8_t)choice);
+            put((uint32_t)drained.size(), 4);
+            for (const GameEvent& e : drained) {
+                size_t n = min<size_t>(e.description.size(), 65535);
+                put(n, 2);
+                bytes.insert(bytes.end(), e.description.begin(), e.description.begin() + n);
+                put((uint32_t)e.priority, 4);
+                for (int st = 0; st < STAT_COUNT; st++) put((uint32_t)e.effect.delta[st], 4);
+            }
+            bytes.push_back(readsWorld);
+            if (readsWorld) {
+                const WorldState& w = game.worldSeen;
+                for (int v : {w.season, w.stormFront, w.preyDensity, w.hunterActivity}) put((uint32_t)v, 4);
+            }
+        }
+        checkpoint();
+    }
+
+    void undoGame() {
+        game.undoGame();
+        bytes.push_back(REPLAY_UNDO);
+        checkpoint();
+    }
+
+    void useItem(const string& name) {
+        game.useItem(name);
+        bytes.push_back(REPLAY_USE);
+        bytes.push_back((uint8_t)min<size_t>(name.size(), 255));
+        bytes.insert(bytes.end(), name.begin(), name.begin() + min<size_t>(name.size(), 255));
+        checkpoint();
+    }
+
+    void redoGame() {
+        game.redoGame();
+        bytes.push_back(REPLAY_REDO);
+        checkpoint();
+    }
+
+    void jumpToTurn(int turn) {
+        game.jumpToTurn(turn);
+        bytes.push_back(REPLAY_JUMP);
+        put((uint32_t)turn, 4);
+        checkpoint();
+    }
+
+    void switchBranch(int index) {
+        game.switchBranch(index);
+        bytes.push_back(REPLAY_BRANCH);
+        put((uint32_t)index, 4);
+        checkpoint();
+    }
+
+    bool save(const string& path) const {
+        ofstream file(path, ios::binary);
+        file.write((const char*)bytes.data(), bytes.size());
+        return (bool)file;
+    }
+
+private:
+    void put(uint64_t v, int n) {
+        for (int i = 0; i < n; i++) bytes.push_back((uint8_t)(v >> (8 * i)));
+    }
+
+    void checkpoint() {
+        roll = rollChecksum(roll, game);
+        put(roll, 4);
+    }
+};
+
+struct ReplayResult {
+    bool ok = false;         // file read and every checksum matched
+    string error;
+    int inputs = 0;          // inputs executed
+    int divergedAt = -1;     // first input whose checksum differs (0-based)
+};
+
+// One REPLAY_TURN record after its op byte: the recorded events go into the
+// queue in the order the inbox gave them, and the turn reads the recorded
+// world. False, with nothing played, if the record is cut short.
+inline bool replayTurn(const vector<uint8_t>& bytes, size_t& pos, GameEngine& g) {
+    size_t at = pos;
+    auto have = [&](size_t n) { return at + n <= bytes.size(); };
+    auto get = [&](int n) {
+        uint64_t v = 0;
+        for (int i = 0; i < n; i++) v |= (uint64_t)bytes[at++] << (8 * i);
+        return v;
+    };
+    if (!have(5)) return false;
+    int choice = (int)get(1);
+    uint32_t count = (uint32_t)get(4);
+    if (count > bytes.size() - at) return false;   // each event takes bytes
+    vector<GameEvent> events(count);
+    for (GameEvent& e : events) {
+        if (!have(2)) return false;
+        size_t n = get(2);
+        if (!have(n + 4 + 4 * STAT_COUNT)) return false;
+        e.description.assign((const char*)&bytes[at], n);
+        at += n;
+        e.priority = (int)(uint32_t)get(4);
+        for (int st = 0; st < STAT_COUNT; st++) e.effect.delta[st] = (int)(uint32_t)get(4);
+    }
+    if (!have(1)) return false;
+    WorldState w;
+    bool readsWorld = get(1);
+    if (readsWorld) {
+        if (!have(16)) return false;
+        w.season = (int)(uint32_t)get(4);
+        w.stormFront = (int)(uint32_t)get(4);
+        w.preyDensity = (int)(uint32_t)get(4);
+        w.hunterActivity = (int)(uint32_t)get(4);
+    }
+    pos = at;
+
+    for (GameEvent& e : events) {
+        g.eventHash += GameEngine::eventKey(e);
+        g.eventQueue.push(move(e));
+    }
+    g.replayWorld = readsWorld ? &w : nullptr;
+    g.makeChoice(choice);
+    g.replayWorld = nullptr;
+    return true;
+}
+
+// Headless: runs the inputs straight through the engine, no output, no saves.
+// The engine must be freshly init()ed; the seed is applied here.
+inline ReplayResult replay(const vector<uint8_t>& bytes, GameEngine& g) {
+    ReplayResult r;
+    if (bytes.size() < 16 || memcmp(bytes.data(), REPLAY_MAGIC, 8) != 0) { r.error = "not a replay file"; return r; }
+    size_t pos = 8;
+    auto get = [&](int n) {
+        uint64_t v = 0;
+        for (int i = 0; i < n; i++) v |= (uint64_t)bytes[pos++] << (8 * i);
+        return v;
+    };
+    g.seed(get(8));
+
+    uint64_t roll = 0;
+    while (pos < bytes.size()) {
+        uint8_t op = bytes[pos++];
+        if (op == REPLAY_CHOICE && pos < bytes.size()) {
+            g.makeChoice(bytes[pos++]);
+        } else if (op == REPLAY_UNDO) {
+            g.undoGame();
+        } else if (op == REPLAY_USE && pos < bytes.size()) {
+            size_t len = bytes[pos++];
+            if (pos + len > bytes.size()) { r.error = "truncated record at offset " + to_string(pos - 2); return r; }
+            g.useItem(string((const char*)&bytes[pos], len));
+            pos += len;
+        } else if (op == REPLAY_REDO) {
+            g.redoGame();
+        } else if (op == REPLAY_TURN) {
+            if (!replayTurn(bytes, pos, g)) { r.error = "truncated record at offset " + to_string(pos); return r; }
+        } else if ((op == REPLAY_JUMP || op == REPLAY_BRANCH) && pos + 4 <= bytes.size()) {
+            int arg = (int)(uint32_t)get(4);
+            if (op == REPLAY_JUMP) g.jumpToTurn(arg);
+            else g.switchBranch(arg);
+        } else {
+            r.error = "bad record at byte " + to_string(pos - 1);
+            return r;
+        }
+        if (pos + 4 > bytes.size()) { r.error = "truncated checksum"; return r; }
+        roll = rollChecksum(roll, g);
+        uint32_t expected = (uint32_t)get(4);
+        if (expected != (uint32_t)roll && r.divergedAt < 0) r.divergedAt = r.inputs;
+        r.inputs++;
+    }
+    r.ok = r.error.empty() && r.divergedAt < 0;
+    return r;
+}
+
+inline bool readReplayFile(const string& path, vector<uint8_t>& bytes) {
+    ifstream file(path, ios::binary);
+    if (!file) return false;
+    bytes.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    return true;
+}
+
+#endif
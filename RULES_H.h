@@ -0,0 +1,136 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include <string_view>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+// --- RULES ---
+// The game's rules with nothing attached: the wolf, effects, the story
+// graph and one turn. Everything here is constant-initialized, so a build
+// that includes only this header (see Kiosk.cpp) runs no code and makes no
+// allocation before main. The engine (GAME_ENGINE_H.h) adds the pack, undo,
+// events and the world on top through playTurn's hooks.
+
+// --- STRUCTS ---
+struct Wolf {
+    int health = 100;
+    int hunger = 0;
+    int energy = 100;
+};
+
+// --- EFFECTS ---
+// Every stat change is an Effect: one delta per stat. Choices, items and
+// events only carry data; a turn sums its effects and applies the total
+// with a single add-and-clamp. A new stat needs a Stat entry, its bounds
+// and its Wolf field below, and nothing else.
+enum Stat { STAT_HEALTH, STAT_HUNGER, STAT_ENERGY, STAT_COUNT };
+
+constexpr int STAT_MIN[STAT_COUNT] = {0, 0, 0};
+constexpr int STAT_MAX[STAT_COUNT] = {100, 100, 100};
+constexpr int Wolf::* STAT_FIELD[STAT_COUNT] = {&Wolf::health, &Wolf::hunger, &Wolf::energy};
+
+struct Effect {
+    int delta[STAT_COUNT] = {};
+
+    constexpr Effect& operator+=(const Effect& o) {
+        for (int s = 0; s < STAT_COUNT; s++) delta[s] += o.delta[s];
+        return *this;
+    }
+};
+
+constexpr Effect statEffect(Stat s, int amount) {
+    Effect e;
+    e.delta[s] = amount;
+    return e;
+}
+
+inline void applyEffect(Wolf& w, const Effect& e) {
+    int v[STAT_COUNT];
+    for (int s = 0; s < STAT_COUNT; s++) v[s] = w.*STAT_FIELD[s];
+    for (int s = 0; s < STAT_COUNT; s++) v[s] = min(STAT_MAX[s], max(STAT_MIN[s], v[s] + e.delta[s]));
+    for (int s = 0; s < STAT_COUNT; s++) w.*STAT_FIELD[s] = v[s];
+}
+
+constexpr Effect TURN_EFFECT = statEffect(STAT_HUNGER, 5);   // every turn, moved or not
+constexpr Effect MOVE_EFFECT[2] = {statEffect(STAT_ENERGY, -10), statEffect(STAT_ENERGY, -5)};   // choice A / B
+
+constexpr int SNOWSTORM_CHANCE = 30;   // percent per turn
+constexpr const char* SNOWSTORM_TEXT = "Sudden Snowstorm! -10 Health";
+constexpr Effect SNOWSTORM_EFFECT = statEffect(STAT_HEALTH, -10);
+
+// Per-session dice (xorshift64*), so a seed replays the same session on any machine.
+inline int rollPercent(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return (int)(((state * 0x2545F4914F6CDD1DULL) >> 32) % 100);
+}
+
+// --- STORY GRAPH ---
+// Scenes sit in one array and name their choices by slot (-1 = none), so
+// a story is plain data: compiled in (STORY_TABLE_H.h), loaded from files
+// (STORY_RELOAD_H.h) or generated (STORY_GEN_H.h), and shared read-only by
+// every session on it. Slot 0 is the opening scene.
+struct StoryNode {
+    int id;
+    string_view description;
+    string_view choiceA;
+    string_view choiceB;
+    int left;    // slot of choice A, -1 if none
+    int right;   // slot of choice B, -1 if none
+    bool isEnding;
+
+    constexpr bool hasChoices() const { return left >= 0 || right >= 0; }
+};
+
+// A view of a story: the scenes and a dense id -> slot index (-1 = no such
+// scene). Whoever owns the arrays keeps them alive while sessions play.
+struct Story {
+    const StoryNode* nodes = nullptr;
+    int count = 0;
+    const int* slotOfId = nullptr;
+    int idLimit = 0;   // ids are 0 .. idLimit - 1
+
+    constexpr const StoryNode* root() const { return count ? &nodes[0] : nullptr; }
+
+    constexpr const StoryNode* find(int id) const {
+        return id >= 0 && id < idLimit && slotOfId[id] >= 0 ? &nodes[slotOfId[id]] : nullptr;
+    }
+
+    constexpr int slotOf(const StoryNode* n) const { return (int)(n - nodes); }
+
+    // Where a choice (1 = A, 2 = B) leads; null if the scene has no such choice.
+    constexpr const StoryNode* next(const StoryNode* at, int choice) const {
+        int slot = choice == 1 ? at->left : (choice == 2 ? at->right : -1);
+        return slot < 0 ? nullptr : &nodes[slot];
+    }
+};
+
+// --- ONE TURN ---
+// The turn every player of a story takes. A turn that starts with an event
+// showing only clears it. Otherwise the wolf follows the choice if the scene
+// has it, grows hungrier, pays the move in energy, and whatever event the
+// dice bring lands on the same turn. Player has story, current, player and
+// eventActive, and three hooks:
+//   beforeTurn()             nothing has changed yet (the engine saves undo)
+//   entered()                current is a new scene (the engine's pickups)
+//   rollEvents(turn, moved)  add this turn's event, if any, to turn
+template <class Player>
+void playTurn(Player& p, int choice) {
+    if (p.eventActive) { p.eventActive = false; return; }
+    p.beforeTurn();
+    Effect turn = TURN_EFFECT;
+    const StoryNode* next = p.story->next(p.current, choice);
+    if (next) {
+        p.current = next;
+        turn += MOVE_EFFECT[choice - 1];
+        p.entered();
+    }
+    p.rollEvents(turn, next != nullptr);
+    applyEffect(p.player, turn);
+}
+
+#endif
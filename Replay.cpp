@@ -0,0 +1,80 @@
+// Headless replayer: re-runs a recorded session and reports the first turn
+// whose state differs from the recording.
+// Build: g++ -O2 -std=c++17 -pthread Replay.cpp -o replay
+// Run:   ./replay session.rpl [times]
+//        ./replay --demo out.rpl [inputs] [seed]   records a random session
+//        ./replay --demo-live ...   same, in a ticking world with events posted from another thread
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include "REPLAY_H.h"
+
+using namespace std;
+
+int demo(const string& path, int inputs, uint64_t seed, bool live) {
+    GameEngine game;
+    game.init();
+    WorldSim world(seed);
+    atomic<bool> done{false};
+    thread poster;
+    if (live) {
+        world.start(chrono::milliseconds(1));
+        game.world = &world;
+        poster = thread([&] {
+            const GameEvent posted[] = {HUNTER_SHOT, PREY_CAUGHT, {"A raven drops a scrap. -5 Hunger", 2, statEffect(STAT_HUNGER, -5)}};
+            for (int i = 0; !done; i++) {
+                game.postEvent(posted[i % 3]);
+                this_thread::sleep_for(chrono::microseconds(200));
+            }
+        });
+    }
+    ReplayRecorder rec(game, seed);
+    uint64_t r = seed;
+    for (int i = 0; i < inputs; i++) {
+        r = zobristMix(r);
+        if (game.current->isEnding) rec.undoGame();
+        else if (r % 20 < 14) rec.makeChoice(1 + (int)(r >> 8) % 2);
+        else if (r % 20 < 17) rec.undoGame();
+        else if (r % 20 == 17) rec.useItem(storyPickups()[(r >> 8) % storyPickups().size()].name);
+        else if (r % 20 == 18) rec.redoGame();
+        else if ((r >> 8) % 2) rec.jumpToTurn((int)((r >> 16) % (game.history.turn() + 1)));
+        else rec.switchBranch((int)((r >> 16) % game.history.branchCount()));
+    }
+    done = true;
+    if (poster.joinable()) poster.join();
+    world.stop();
+    if (!rec.save(path)) { cerr << "could not write " << path << endl; return 1; }
+    cout << "recorded " << inputs << " inputs (" << rec.bytes.size() << " bytes) to " << path << endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { cerr << "usage: replay file.rpl [times] | --demo[-live] out.rpl [inputs] [seed]" << endl; return 1; }
+    string mode = argv[1];
+    if ((mode == "--demo" || mode == "--demo-live") && argc > 2)
+        return demo(argv[2], argc > 3 ? atoi(argv[3]) : 1000, argc > 4 ? strtoull(argv[4], nullptr, 10) : 42, mode == "--demo-live");
+
+    vector<uint8_t> bytes;
+    if (!readReplayFile(argv[1], bytes)) { cerr << "could not read " << argv[1] << endl; return 1; }
+    int times = argc > 2 ? atoi(argv[2]) : 1;
+
+    ReplayResult r;
+    auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < times; i++) {
+        GameEngine game;
+        game.init();
+        r = replay(bytes, game);
+        if (!r.ok) break;
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    if (!r.error.empty()) { cout << "error: " << r.error << endl; return 2; }
+    if (r.divergedAt >= 0) { cout << "DIVERGED at input " << r.divergedAt << " of " << r.inputs << endl; return 3; }
+    cout << "ok: " << r.inputs << " inputs match";
+    if (secs > 0) cout << ", " << (long long)(r.inputs * (double)times / secs) << " inputs/s";
+    cout << endl;
+    return 0;
+}
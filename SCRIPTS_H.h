@@ -0,0 +1,390 @@
+#ifndef SCRIPTS_H
+#define SCRIPTS_H
+
+// C++20: g++ -std=c++20
+#include <coroutine>
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <exception>
+#include "GAME_ENGINE_H.h"
+
+using namespace std;
+
+// --- STORY SCRIPTS ---
+// A script is a coroutine that co_awaits story conditions:
+//
+//     int why = co_await (run.turns(3) || run.leave(12));
+//
+// Each wait is filed in an index for its kind of condition (turn map,
+// per-scene lists, per-stat threshold maps, next-choice list). After a turn
+// the runner only looks up the entries that fire, so the cost of a turn
+// grows with the scripts that wake, not with the scripts that exist.
+// co_await gives the position of the condition that fired (0 for the left-
+// most). A script waiting on several is filed under each and keeps a handle
+// to every entry; the first to fire wakes it and unfiles the rest.
+//
+// The runner listens to its engine, so whatever drives the engine (bot
+// commands, a session manager) drives the scripts. Script state is not part
+// of a snapshot: undo and the other kinds of time travel cancel every script
+// a scene or an item started, then the scene travelled to is entered afresh
+// and its scripts start over. Scripts started with start() keep waiting.
+// Replays (REPLAY_H.h) run without scripts, so record sessions without them.
+struct ScriptRunner;
+
+struct Script {
+    struct promise_type {
+        int slot = -1;
+        Script get_return_object() { return Script{coroutine_handle<promise_type>::from_promise(*this)}; }
+        suspend_always initial_suspend() noexcept { return {}; }
+        suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { terminate(); }
+    };
+    coroutine_handle<promise_type> handle;
+};
+
+typedef function<Script(ScriptRunner&)> ScriptFactory;
+
+enum WaitKind { W_TURNS, W_CHOICE, W_ENTER, W_LEAVE, W_BELOW, W_ABOVE };
+
+struct WaitCondition {
+    WaitKind kind;
+    int a;   // turns / scene id / stat
+    int b;   // threshold
+};
+
+struct Waiter {
+    int slot;
+    uint64_t ticket;
+    int which;   // index of the condition within its wait
+};
+
+struct Wait {
+    ScriptRunner* runner;
+    vector<WaitCondition> conditions;
+    int slot = -1;
+
+    bool await_ready() const;
+    void await_suspend(coroutine_handle<Script::promise_type> h);
+    int await_resume() const;
+};
+
+inline Wait operator||(Wait a, const Wait& b) {
+    a.conditions.insert(a.conditions.end(), b.conditions.begin(), b.conditions.end());
+    return a;
+}
+
+struct ScriptRunner : GameEngine::Listener {
+    typedef list<Waiter> WaiterList;
+    typedef multimap<int, Waiter> WaiterMap;
+
+    // Where one condition of the current wait is filed.
+    struct Filed {
+        WaitKind kind;
+        int a;
+        bool live = true;   // false once taken out to wake
+        WaiterList::iterator inList;
+        WaiterMap::iterator inMap;
+    };
+
+    struct Slot {
+        coroutine_handle<Script::promise_type> handle;
+        uint64_t ticket = 0;      // current wait; 0 = not waiting
+        int woke = -1;
+        bool triggered = false;   // started by a scene or an item
+        vector<Filed> filed;
+    };
+
+    GameEngine& game;
+    int turn = 0;
+    int lastChoice = 0;
+
+    explicit ScriptRunner(GameEngine& g) : game(g) { game.listener = this; }
+    ~ScriptRunner() {
+        if (game.listener == this) game.listener = nullptr;
+        for (Slot& s : slots)
+            if (s.handle) s.handle.destroy();
+    }
+
+    ScriptRunner(const ScriptRunner&) = delete;
+    ScriptRunner& operator=(const ScriptRunner&) = delete;
+
+    // --- ATTACHING ---
+    void onEnter(int nodeId, ScriptFactory f) { enterScripts[nodeId].push_back(move(f)); }
+    void onUse(const string& item, ScriptFactory f) { useScripts[item].push_back(move(f)); }
+
+    // Runs s up to its first co_await.
+    void start(Script s) { start(s, false); }
+
+    int running() const { return (int)(slots.size() - freeSlots.size()); }
+
+    // Entries filed for one kind of condition, for checks.
+    size_t filedFor(WaitKind kind, int a = 0) const {
+        switch (kind) {
+        case W_TURNS: return turnWaiters.size();
+        case W_CHOICE: return choiceWaiters.size();
+        case W_ENTER: { auto it = enterWaiters.find(a); return it == enterWaiters.end() ? 0 : it->second.size(); }
+        case W_LEAVE: { auto it = leaveWaiters.find(a); return it == leaveWaiters.end() ? 0 : it->second.size(); }
+        case W_BELOW: return belowWaiters[a].size();
+        case W_ABOVE: return aboveWaiters[a].size();
+        }
+        return 0;
+    }
+
+    // --- AWAITABLES ---
+    Wait turns(int n) { return {this, {{W_TURNS, n, 0}}}; }
+    Wait choice() { return {this, {{W_CHOICE, 0, 0}}}; }             // lastChoice says which
+    Wait enter(int nodeId) { return {this, {{W_ENTER, nodeId, 0}}}; }
+    Wait leave(int nodeId) { return {this, {{W_LEAVE, nodeId, 0}}}; }
+    Wait below(Stat s, int v) { return {this, {{W_BELOW, s, v}}}; }   // stat < v
+    Wait above(Stat s, int v) { return {this, {{W_ABOVE, s, v}}}; }   // stat > v
+
+    // --- WHAT SCRIPTS DO ---
+    // Queued like any other event: it hits on the next turn.
+    void fire(const GameEvent& e) {
+        game.eventQueue.push(e);
+        game.eventHash += GameEngine::eventKey(e);
+    }
+
+    void apply(const Effect& e) {
+        Wolf before = game.player;
+        applyEffect(game.player, e);
+        game.fieldHash ^= GameEngine::wolfKey(before) ^ GameEngine::wolfKey(game.player);
+    }
+
+    // --- ENGINE EVENTS ---
+    void turnPlayed(const StoryNode* from, int choice) override {
+        turn++;
+        lastChoice = choice;
+
+        vector<Waiter> ready;
+        for (const Waiter& w : choiceWaiters) taken(w, ready);
+        choiceWaiters.clear();
+        if (game.current != from) {
+            take(leaveWaiters, from->id, ready);
+            take(enterWaiters, game.current->id, ready);
+        }
+        takeStats(ready);
+        while (!turnWaiters.empty() && turnWaiters.begin()->first <= turn) {
+            taken(turnWaiters.begin()->second, ready);
+            turnWaiters.erase(turnWaiters.begin());
+        }
+        wake(ready);
+        if (game.current != from) startAll(enterScripts, game.current->id);
+    }
+
+    void itemUsed(const string& name) override {
+        vector<Waiter> ready;
+        takeStats(ready);
+        wake(ready);
+        startAll(useScripts, name);
+    }
+
+    void timeTravelled(const StoryNode* from) override {
+        for (int slot : vector<int>(triggered.begin(), triggered.end())) release(slot);
+        vector<Waiter> ready;
+        if (game.current != from) {
+            take(leaveWaiters, from->id, ready);
+            take(enterWaiters, game.current->id, ready);
+        }
+        takeStats(ready);
+        wake(ready);
+        startAll(enterScripts, game.current->id);
+    }
+
+private:
+    friend struct Wait;
+
+    vector<Slot> slots;
+    vector<int> freeSlots;
+    unordered_set<int> triggered;   // slots time travel cancels
+    uint64_t nextTicket = 1;
+
+    WaiterMap turnWaiters;   // by due turn
+    WaiterList choiceWaiters;
+    unordered_map<int, WaiterList> enterWaiters, leaveWaiters;
+    WaiterMap belowWaiters[STAT_COUNT], aboveWaiters[STAT_COUNT];   // by threshold
+
+    unordered_map<int, vector<ScriptFactory>> enterScripts;
+    unordered_map<string, vector<ScriptFactory>> useScripts;
+
+    void start(Script s, bool byTrigger) {
+        int slot;
+        if (!freeSlots.empty()) { slot = freeSlots.back(); freeSlots.pop_back(); }
+        else { slot = (int)slots.size(); slots.push_back(Slot()); }
+        slots[slot].handle = s.handle;
+        slots[slot].triggered = byTrigger;
+        if (byTrigger) triggered.insert(slot);
+        s.handle.promise().slot = slot;
+        resume(slot);
+    }
+
+    template <class K>
+    void startAll(unordered_map<K, vector<ScriptFactory>>& scripts, const K& key) {
+        auto it = scripts.find(key);
+        if (it == scripts.end()) return;
+        for (ScriptFactory& f : it->second) start(f(*this), true);
+    }
+
+    bool holds(const WaitCondition& c) const {
+        if (c.kind == W_TURNS) return c.a <= 0;
+        if (c.kind == W_BELOW) return game.player.*STAT_FIELD[c.a] < c.b;
+        if (c.kind == W_ABOVE) return game.player.*STAT_FIELD[c.a] > c.b;
+        return false;
+    }
+
+    void park(int slot, const vector<WaitCondition>& conditions) {
+        Slot& s = slots[slot];
+        s.ticket = nextTicket++;
+        s.filed.clear();
+        for (int i = 0; i < (int)conditions.size(); i++) {
+            const WaitCondition& c = conditions[i];
+            Waiter w = {slot, s.ticket, i};
+            Filed f;
+            f.kind = c.kind;
+            f.a = c.a;
+            switch (c.kind) {
+            case W_TURNS: f.inMap = turnWaiters.emplace(turn + c.a, w); break;
+            case W_CHOICE: f.inList = choiceWaiters.insert(choiceWaiters.end(), w); break;
+            case W_ENTER: { WaiterList& l = enterWaiters[c.a]; f.inList = l.insert(l.end(), w); break; }
+            case W_LEAVE: { WaiterList& l = leaveWaiters[c.a]; f.inList = l.insert(l.end(), w); break; }
+            case W_BELOW: f.inMap = belowWaiters[c.a].emplace(c.b, w); break;
+            case W_ABOVE: f.inMap = aboveWaiters[c.a].emplace(c.b, w); break;
+            }
+            s.filed.push_back(f);
+        }
+    }
+
+    // w is leaving its index to wake: its handle no longer points anywhere.
+    void taken(const Waiter& w, vector<Waiter>& ready) {
+        Slot& s = slots[w.slot];
+        if (s.ticket == w.ticket) s.filed[w.which].live = false;
+        ready.push_back(w);
+    }
+
+    void take(unordered_map<int, WaiterList>& index, int id, vector<Waiter>& ready) {
+        auto it = index.find(id);
+        if (it == index.end()) return;
+        for (const Waiter& w : it->second) taken(w, ready);
+        index.erase(it);
+    }
+
+    // Only the thresholds the current value has crossed are touched.
+    void takeStats(vector<Waiter>& ready) {
+        for (int s = 0; s < STAT_COUNT; s++) {
+            int v = game.player.*STAT_FIELD[s];
+            auto firstBelow = belowWaiters[s].upper_bound(v);
+            for (auto it = firstBelow; it != belowWaiters[s].end(); ++it) taken(it->second, ready);
+            belowWaiters[s].erase(firstBelow, belowWaiters[s].end());
+            auto lastAbove = aboveWaiters[s].lower_bound(v);
+            for (auto it = aboveWaiters[s].begin(); it != lastAbove; ++it) taken(it->second, ready);
+            aboveWaiters[s].erase(aboveWaiters[s].begin(), lastAbove);
+        }
+    }
+
+    // Drops whatever the slot's current wait still has filed.
+    void unfile(int slot) {
+        for (Filed& f : slots[slot].filed) {
+            if (!f.live) continue;
+            switch (f.kind) {
+            case W_TURNS: turnWaiters.erase(f.inMap); break;
+            case W_CHOICE: choiceWaiters.erase(f.inList); break;
+            case W_ENTER: unfileFrom(enterWaiters, f); break;
+            case W_LEAVE: unfileFrom(leaveWaiters, f); break;
+            case W_BELOW: belowWaiters[f.a].erase(f.inMap); break;
+            case W_ABOVE: aboveWaiters[f.a].erase(f.inMap); break;
+            }
+        }
+        slots[slot].filed.clear();
+    }
+
+    static void unfileFrom(unordered_map<int, WaiterList>& index, const Filed& f) {
+        auto it = index.find(f.a);
+        it->second.erase(f.inList);
+        if (it->second.empty()) index.erase(it);
+    }
+
+    void wake(const vector<Waiter>& ready) {
+        for (const Waiter& w : ready) {
+            Slot& s = slots[w.slot];
+            if (!s.handle || s.ticket != w.ticket) continue;   // already woken by another condition
+            unfile(w.slot);
+            s.ticket = 0;
+            s.woke = w.which;
+            resume(w.slot);
+        }
+    }
+
+    void resume(int slot) {
+        coroutine_handle<Script::promise_type> h = slots[slot].handle;
+        h.resume();
+        if (h.done()) release(slot);
+    }
+
+    void release(int slot) {
+        unfile(slot);
+        slots[slot].handle.destroy();
+        triggered.erase(slot);
+        slots[slot] = Slot();
+        freeSlots.push_back(slot);
+    }
+};
+
+inline bool Wait::await_ready() const {
+    for (const WaitCondition& c : conditions)
+        if (runner->holds(c)) return true;
+    return false;
+}
+
+inline void Wait::await_suspend(coroutine_handle<Script::promise_type> h) {
+    slot = h.promise().slot;
+    runner->park(slot, conditions);
+}
+
+inline int Wait::await_resume() const {
+    if (slot < 0) {   // never suspended: report the condition that already held
+        for (int i = 0; i < (int)conditions.size(); i++)
+            if (runner->holds(conditions[i])) return i;
+        return 0;
+    }
+    return runner->slots[slot].woke;
+}
+
+// --- STORY SCRIPTS ---
+// The hunters whose scent fills scene 12 close in over three turns
+// unless the wolf moves on; a turn spent weathering a storm doesn't count
+// as moving.
+inline Script huntersCloseIn(ScriptRunner& run) {
+    for (int left = 3; left > 0; left--) {
+        run.game.currentMessage = "Hunters close in... (" + to_string(left) + ")";
+        if (co_await (run.turns(1) || run.leave(12)) == 1) co_return;
+    }
+    run.fire({"Hunters' ambush! -40 Health", 1, statEffect(STAT_HEALTH, -40)});
+}
+
+// Herbs keep working: +5 health for each of the next three turns.
+inline Script herbsLinger(ScriptRunner& run) {
+    for (int i = 0; i < 3; i++) {
+        co_await run.turns(1);
+        run.apply(statEffect(STAT_HEALTH, 5));
+    }
+}
+
+// One warning the first time hunger passes 80.
+inline Script hungerPangs(ScriptRunner& run) {
+    co_await run.above(STAT_HUNGER, 80);
+    run.game.currentMessage = "Your stomach cramps. Find food soon.";
+}
+
+inline void addStoryScripts(ScriptRunner& run) {
+    run.onEnter(12, huntersCloseIn);
+    run.onUse("Medical Herbs", herbsLinger);
+    run.start(hungerPangs(run));
+}
+
+#endif
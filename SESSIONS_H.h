@@ -0,0 +1,447 @@
+#ifndef SESSIONS_H
+#define SESSIONS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include "GAME_ENGINE_H.h"
+#include "COMMANDS_H.h"
+#include "METRICS_H.h"
+
+using namespace std;
+
+// --- SESSION FILES ---
+// "WOLFSES4", then little-endian fields: dice, the live state, and the undo
+// history: each distinct snapshot once, the root's turn, then the tree's
+// nodes parents first (snapshot index, parent, lastChild) and the node the
+// session is at.
+// A state is scene id, stats, the active event, pending events and the pack.
+// Strings are u16 length + bytes; an effect is STAT_COUNT i32 deltas.
+const char SESSION_MAGIC[9] = "WOLFSES4";
+
+struct SessionWriter {
+    vector<uint8_t> bytes;
+
+    void u8(uint8_t v) { bytes.push_back(v); }
+    void u64(uint64_t v) { for (int i = 0; i < 8; i++) bytes.push_back((uint8_t)(v >> (8 * i))); }
+    void i32(int32_t v) { for (int i = 0; i < 4; i++) bytes.push_back((uint8_t)((uint32_t)v >> (8 * i))); }
+    void str(const string& s) {
+        uint16_t n = (uint16_t)min<size_t>(s.size(), 65535);
+        bytes.push_back((uint8_t)n);
+        bytes.push_back((uint8_t)(n >> 8));
+        bytes.insert(bytes.end(), s.begin(), s.begin() + n);
+    }
+    void wolf(const Wolf& w) { i32(w.health); i32(w.hunger); i32(w.energy); }
+    void event(const GameEvent& e) {
+        str(e.description);
+        i32(e.priority);
+        for (int s = 0; s < STAT_COUNT; s++) i32(e.effect.delta[s]);
+    }
+    void items(const Item* head) {
+        uint32_t n = 0;
+        for (const Item* i = head; i; i = i->next.get()) n++;
+        i32((int32_t)n);
+        for (const Item* i = head; i; i = i->next.get()) { str(i->name); str(i->type); i32(i->effect); }
+    }
+    void state(const Snapshot& s) {
+        i32(s.nodeId);
+        wolf(s.wolf);
+        u8(s.eventActive);
+        event(s.activeEvent);
+        i32(s.events ? (int32_t)s.events->size() : 0);
+        if (s.events)
+            for (const GameEvent& e : *s.events) event(e);
+        items(s.items.get());
+    }
+};
+
+struct SessionReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok = true;
+
+    bool need(size_t n) { if ((size_t)(end - p) < n) ok = false; return ok; }
+    uint8_t u8() { return need(1) ? *p++ : 0; }
+    uint64_t u64() {
+        if (!need(8)) return 0;
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++) v |= (uint64_t)*p++ << (8 * i);
+        return v;
+    }
+    int32_t i32() {
+        if (!need(4)) return 0;
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) v |= (uint32_t)*p++ << (8 * i);
+        return (int32_t)v;
+    }
+    string str() {
+        if (!need(2)) return "";
+        size_t n = p[0] | (p[1] << 8);
+        p += 2;
+        if (!need(n)) return "";
+        string s((const char*)p, n);
+        p += n;
+        return s;
+    }
+    Wolf wolf() { Wolf w; w.health = i32(); w.hunger = i32(); w.energy = i32(); return w; }
+    GameEvent event() {
+        GameEvent e;
+        e.description = str();
+        e.priority = i32();
+        for (int s = 0; s < STAT_COUNT; s++) e.effect.delta[s] = i32();
+        return e;
+    }
+    shared_ptr<const Item> items() {
+        vector<Item> read;
+        for (int32_t n = i32(); n > 0 && ok; n--) {
+            Item i;
+            i.name = str(); i.type = str(); i.effect = i32();
+            i.onUse = itemEffect(i.type, i.effect);
+            read.push_back(move(i));
+        }
+        shared_ptr<const Item> pack;
+        for (size_t k = read.size(); k-- > 0;) {   // built from the back: each item links to the rest
+            read[k].next = pack;
+            pack = make_shared<const Item>(move(read[k]));
+        }
+        return pack;
+    }
+    // Without its hash: restore it into an engine and capture() to get one.
+    Snapshot state() {
+        Snapshot s;
+        s.hash = 0;
+        s.nodeId = i32();
+        s.wolf = wolf();
+        s.eventActive = u8();
+        s.activeEvent = event();
+        vector<GameEvent> pending;
+        for (int32_t n = i32(); n > 0 && ok; n--) pending.push_back(event());
+        if (!pending.empty()) s.events = make_shared<const vector<GameEvent>>(move(pending));
+        s.items = items();
+        return s;
+    }
+};
+
+inline vector<uint8_t> saveSession(GameEngine& g) {
+    g.drainInbox();
+    SessionWriter w;
+    w.bytes.insert(w.bytes.end(), SESSION_MAGIC, SESSION_MAGIC + 8);
+    w.u64(g.rngState);
+    w.state(g.capture());
+    const History& h = g.history;
+    unordered_map<const Snapshot*, int32_t> index;
+    vector<const Snapshot*> distinct;
+    for (const HistoryNode& n : h.nodes)
+        if (index.emplace(n.state.get(), (int32_t)distinct.size()).second) distinct.push_back(n.state.get());
+    w.i32((int32_t)distinct.size());
+    for (const Snapshot* s : distinct) w.state(*s);
+    w.i32(h.base);
+    w.i32((int32_t)h.nodes.size());
+    for (const HistoryNode& n : h.nodes) {
+        w.i32(index[n.state.get()]);
+        w.i32(n.parent);
+        w.i32(n.lastChild);
+    }
+    w.i32(h.at);
+    return w.bytes;
+}
+
+// g must be empty apart from its story (story set, nothing played).
+inline bool loadSession(GameEngine& g, const vector<uint8_t>& bytes) {
+    if (bytes.size() < 8 || memcmp(bytes.data(), SESSION_MAGIC, 8) != 0) return false;
+    SessionReader r{bytes.data() + 8, bytes.data() + bytes.size()};
+    g.seed(r.u64());
+    Snapshot live = r.state();
+    if (!r.ok || !g.findNode(live.nodeId)) return false;
+
+    // Each snapshot goes through the engine once to get its hash, then is
+    // interned: other sessions in the same state share it.
+    vector<shared_ptr<const Snapshot>> distinct;
+    for (int32_t n = r.i32(); n > 0 && r.ok; n--) {
+        Snapshot s = r.state();
+        if (!r.ok || !g.findNode(s.nodeId)) return false;
+        g.restore(s);
+        distinct.push_back(g.snapshots->intern(g.capture()));
+    }
+    History& h = g.history;
+    h.base = r.i32();
+    if (h.base < 0) return false;
+    vector<int32_t> lastChild;
+    for (int32_t n = r.i32(), i = 0; i < n && r.ok; i++) {
+        int32_t state = r.i32(), parent = r.i32();
+        lastChild.push_back(r.i32());
+        if (state < 0 || state >= (int32_t)distinct.size() || parent < -1 || parent >= i) return false;
+        h.add(distinct[state], parent);
+    }
+    for (int i = 0; i < (int)h.nodes.size(); i++) {   // add() moved each parent's to its newest child
+        int32_t c = lastChild[i];
+        if (c < -1 || c >= (int)h.nodes.size() || (c >= 0 && h.nodes[c].parent != i)) return false;
+        h.nodes[i].lastChild = c;
+    }
+    h.at = r.i32();
+    if (h.at < -1 || h.at >= (int)h.nodes.size()) return false;
+    g.restore(live);
+    return r.ok;
+}
+
+// --- SESSION MANAGER ---
+// Owns every session of a server. Sessions idle longest are written to
+// <dir>/<id>.ses and freed whenever the resident ones go over the memory
+// budget; the next command for an evicted session reads it back first.
+// Each session has its own lock, held while its commands run or while it is
+// paged in or out. The manager's lock covers only the session table, the
+// LRU list and the byte count, so sessions never wait on each other.
+// Lock order: a session's lock, then the manager's (eviction only try_locks).
+// Session files are scratch space and are removed with the manager, or with
+// the session when it is closed. A session's undo history keeps its last
+// historyTurns turns (and the branches opened off them); older turns are
+// dropped once it holds twice that, and before every page-out. The "save"
+// command writes <dir>/<id>.save.txt, which is the player's and stays.
+struct SessionManager {
+    struct Entry {
+        mutex lock;                               // the session's own
+        unique_ptr<GameEngine> live;              // null while on disk
+        vector<GameEvent> mail;                   // posted while on disk
+        long long turns = 0;                      // choices made so far
+        // Under both locks:
+        bool closed = false;                      // out of the table; holders of the entry must let go
+        // Under the manager's lock:
+        bool listed = false;                      // in the LRU list
+        list<uint64_t>::iterator lru;             // valid while listed
+        size_t bytes = 0;                         // estimated, while listed
+    };
+
+    string dir;
+    size_t budget;
+    int historyTurns = 256;
+    const Story& story;                           // shared by every session, outlives the manager
+    unordered_map<uint64_t, shared_ptr<Entry>> sessions;
+    list<uint64_t> lru;                           // most recently used first
+    size_t resident = 0;
+    uint64_t nextId = 1;
+    atomic<long long> evictions{0}, pageIns{0};
+    AnalyticsWriter* analytics = nullptr;         // optional turn log, outlives the manager
+    mutex lock;
+
+    SessionManager(const string& directory, size_t budgetBytes, const Story& s = STORY)
+        : dir(directory), budget(budgetBytes), story(s) {}
+
+    ~SessionManager() {
+        for (auto& kv : sessions) remove(path(kv.first).c_str());
+    }
+
+    uint64_t create() {
+        uint64_t id;
+        {
+            lock_guard<mutex> guard(lock);
+            id = nextId++;
+            shared_ptr<Entry>& slot = sessions[id];
+            slot = make_shared<Entry>();
+            Entry& e = *slot;
+            e.live = fresh();
+            e.live->seed(zobristMix(id ^ (uint64_t)time(0)));
+            touch(id, e, measure(e));
+        }
+        enforceBudget(id);
+        return id;
+    }
+
+    // Runs text commands (whole lines, see COMMANDS_H.h) and returns the replies.
+    string handle(uint64_t id, string_view lines) {
+        shared_ptr<Entry> e = find(id);
+        if (!e) return "ERR no such session\n";
+        string out;
+        {
+            lock_guard<mutex> own(e->lock);
+            if (e->closed) return "ERR no such session\n";
+            string error;
+            if (!e->live && !pageIn(id, *e, error)) return "ERR session unavailable: " + error + "\n";
+            CommandSession cmd(*e->live);
+            cmd.analytics = analytics;
+            cmd.sessionId = id;
+            cmd.turns = e->turns;
+            cmd.savePath = savePath(id);
+            cmd.feed(lines.data(), lines.size());
+            cmd.finish();
+            e->turns = cmd.turns;
+            History& h = e->live->history;
+            if (h.turn() - h.base > 2 * historyTurns) h.compact(historyTurns);
+            size_t bytes = measure(*e);
+            lock_guard<mutex> guard(lock);
+            touch(id, *e, bytes);
+            out = move(cmd.out);
+        }
+        enforceBudget(id);
+        return out;
+    }
+
+    // Delivered at the session's next turn, resident or not.
+    bool post(uint64_t id, const GameEvent& ev) {
+        shared_ptr<Entry> e = find(id);
+        if (!e) return false;
+        lock_guard<mutex> own(e->lock);
+        if (e->closed) return false;
+        if (e->live) return e->live->postEvent(ev);
+        e->mail.push_back(ev);
+        return true;
+    }
+
+    // Ends a session: its engine, its session file and its table entry go.
+    // Commands that were waiting for it then get "no such session".
+    bool close(uint64_t id) {
+        shared_ptr<Entry> e = find(id);
+        if (!e) return false;
+        lock_guard<mutex> own(e->lock);
+        {
+            lock_guard<mutex> guard(lock);
+            if (e->closed) return false;
+            e->closed = true;
+            if (e->listed) {
+                lru.erase(e->lru);
+                e->listed = false;
+                resident -= e->bytes;
+            }
+            sessions.erase(id);
+        }
+        e->live.reset();
+        remove(path(id).c_str());
+        return true;
+    }
+
+    size_t residentCount() {
+        lock_guard<mutex> guard(lock);
+        return lru.size();
+    }
+
+    size_t sessionCount() {
+        lock_guard<mutex> guard(lock);
+        return sessions.size();
+    }
+
+    string savePath(uint64_t id) const { return dir + "/" + to_string(id) + ".save.txt"; }
+
+private:
+    string path(uint64_t id) const { return dir + "/" + to_string(id) + ".ses"; }
+
+    // The entry outlives its table slot for as long as the caller holds it.
+    shared_ptr<Entry> find(uint64_t id) {
+        lock_guard<mutex> guard(lock);
+        auto it = sessions.find(id);
+        return it == sessions.end() ? nullptr : it->second;
+    }
+
+    unique_ptr<GameEngine> fresh() {
+        unique_ptr<GameEngine> g(new GameEngine);
+        g->start(story);
+        metricsCount(C_SESSIONS);
+        return g;
+    }
+
+    // Under e.lock. On failure the session stays on disk with its mail, and
+    // the next command for it tries again.
+    bool pageIn(uint64_t id, Entry& e, string& error) {
+        ScopedTimer timing(T_LOAD);
+        vector<uint8_t> bytes;
+        FILE* f = fopen(path(id).c_str(), "rb");
+        if (!f) { error = "cannot open " + path(id) + ": " + strerror(errno); return false; }
+        char buf[65536];
+        for (size_t n; (n = fread(buf, 1, sizeof buf, f)) > 0;) bytes.insert(bytes.end(), buf, buf + n);
+        bool readOk = !ferror(f);
+        fclose(f);
+        if (!readOk) { error = "cannot read " + path(id); return false; }
+        unique_ptr<GameEngine> g(new GameEngine);
+        g->story = &story;
+        if (!loadSession(*g, bytes)) { error = "corrupt session file " + path(id); return false; }
+        for (const GameEvent& ev : e.mail) {
+            g->eventQueue.push(ev);
+            g->eventHash += GameEngine::eventKey(ev);
+        }
+        e.mail.clear();
+        e.live = move(g);
+        pageIns++;
+        return true;
+    }
+
+    // Estimated heap footprint, under e.lock. The history keeps its own
+    // running total, so this is O(pack) however long the session has run.
+    size_t measure(Entry& e) {
+        GameEngine& g = *e.live;
+        size_t now = sizeof(GameEngine) + g.inbox.capacity() * sizeof(MpscInbox<GameEvent>::Cell)
+                   + g.history.bytes + g.inventoryText.size();
+        for (const Item* i = g.inventoryHead.get(); i; i = i->next.get()) now += sizeof(Item) + i->name.size() + i->type.size();
+        return now;
+    }
+
+    // Under the manager's lock: most recently used, now this big.
+    void touch(uint64_t id, Entry& e, size_t bytes) {
+        if (e.listed) {
+            lru.splice(lru.begin(), lru, e.lru);
+        } else {
+            lru.push_front(id);
+            e.lru = lru.begin();
+            e.listed = true;
+            e.bytes = 0;
+        }
+        resident = resident - e.bytes + bytes;
+        e.bytes = bytes;
+    }
+
+    // Pages out from the cold end. Sessions busy running a command are
+    // skipped rather than waited for, and a full round of failed writes ends it.
+    void enforceBudget(uint64_t keep) {
+        for (size_t failures = 0;;) {
+            uint64_t id = 0;
+            shared_ptr<Entry> victim;
+            {
+                lock_guard<mutex> guard(lock);
+                if (resident <= budget || failures >= lru.size()) return;
+                for (auto it = lru.rbegin(); it != lru.rend(); ++it) {
+                    const shared_ptr<Entry>& e = sessions.find(*it)->second;
+                    if (*it == keep || !e->lock.try_lock()) continue;
+                    id = *it;
+                    victim = e;
+                    break;
+                }
+                if (!victim) return;
+                lru.erase(victim->lru);
+                victim->listed = false;
+                resident -= victim->bytes;
+            }
+            bool ok = evict(id, *victim);
+            {
+                lock_guard<mutex> guard(lock);
+                if (ok) evictions++;
+                else { touch(id, *victim, victim->bytes); failures++; }   // can't page out: keep it, try the next one
+            }
+            victim->lock.unlock();
+        }
+    }
+
+    // Under e.lock, with e already off the LRU list.
+    bool evict(uint64_t id, Entry& e) {
+        ScopedTimer timing(T_SAVE_FILE);
+        e.live->history.compact(historyTurns);
+        vector<uint8_t> bytes = saveSession(*e.live);
+        string p = path(id), tmp = p + ".tmp";
+        FILE* f = fopen(tmp.c_str(), "wb");
+        bool ok = f && fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        if (f) ok = fclose(f) == 0 && ok;
+        if (!ok || rename(tmp.c_str(), p.c_str()) != 0) {
+            remove(tmp.c_str());
+            return false;
+        }
+        e.live.reset();
+        return true;
+    }
+};
+
+#endif
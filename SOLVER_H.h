@@ -0,0 +1,263 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include "GAME_ENGINE_H.h"
+#include "STORY_LAYOUT_H.h"
+#include "TRANSPOSITION_H.h"
+
+using namespace std;
+
+// --- SURVIVAL MODEL ---
+// The wolf dies when health runs out, hunger reaches 100 or energy runs out
+// (the collapse rule from Main.cpp). Reaching an ending alive counts as
+// survival unless the ending itself is a death.
+//
+// Only the snowstorm is modelled, at SNOWSTORM_CHANCE: the odds of a
+// session with no world attached and nothing posted to its inbox. Hunters,
+// prey and the last stretch (WORLD_H.h) and injected events are not, so
+// results for sessions in a live world are optimistic.
+inline bool isDeath(int health, int hunger, int energy) {
+    return health <= 0 || hunger >= 100 || energy <= 0;
+}
+
+inline bool isSurvivalEnding(string_view description) {
+    static const char* deaths[] = {"Death", "Fatal", "Killed", "Sacrifice", "Frozen", "Collapse", "Starvation"};
+    for (const char* d : deaths)
+        if (description.find(d) != string_view::npos) return false;
+    return true;
+}
+
+// --- STATES ---
+// (scene, health, hunger, energy, how many of each pickup are held), packed
+// into 64 bits: slot 22 | health 7 | hunger 7 | energy 7 | 3 bits per pickup.
+// Stats are clamped to 0..100 (STAT_MAX) so 7 bits hold them; stories with
+// more than SOLVER_MAX_SLOTS scenes are refused by Solver::load.
+const int SOLVER_MAX_PICKUPS = 7;
+const int SOLVER_MAX_HELD = 7;
+const int SOLVER_SLOT_BITS = 64 - 3 * 7 - 3 * SOLVER_MAX_PICKUPS;
+const size_t SOLVER_MAX_SLOTS = (size_t)1 << SOLVER_SLOT_BITS;
+
+struct SolverState {
+    int slot;
+    int health, hunger, energy;
+    int held[SOLVER_MAX_PICKUPS];
+
+    Wolf wolf() const {
+        Wolf w;
+        w.health = health; w.hunger = hunger; w.energy = energy;
+        return w;
+    }
+
+    // Same add-and-clamp as the engine.
+    SolverState after(const Effect& e) const {
+        Wolf w = wolf();
+        applyEffect(w, e);
+        SolverState s = *this;
+        s.health = w.health; s.hunger = w.hunger; s.energy = w.energy;
+        return s;
+    }
+
+    uint64_t key() const {
+        uint64_t k = (uint64_t)slot;
+        k = (k << 7) | (uint64_t)min(127, max(0, health));
+        k = (k << 7) | (uint64_t)min(127, max(0, hunger));
+        k = (k << 7) | (uint64_t)min(127, max(0, energy));
+        for (int i = 0; i < SOLVER_MAX_PICKUPS; i++) k = (k << 3) | (uint64_t)held[i];
+        return k;
+    }
+};
+
+// Per state: what to do and how likely the wolf survives doing it.
+// choice 0 = no move (terminal); uses = how many of each pickup to use
+// first (the engine allows any number of items between turns).
+struct SolverResult {
+    int choice = 0;
+    int uses[SOLVER_MAX_PICKUPS] = {};
+    double survival = 0;
+    double choiceValue[2] = {0, 0};   // best value after choice A / B (-1 = not available)
+};
+
+struct Outcome {
+    SolverState next;
+    double probability;
+};
+
+struct Solver {
+    StoryLayout story;
+    vector<Pickup> pickups;
+    vector<Effect> pickupEffect;  // what using each pickup does
+    vector<int> pickupAt;         // by slot, index into pickups or -1
+    vector<char> survivesAt;      // by slot, for endings
+    vector<SolverState> states;
+    TranspositionTable<int> indexOf;   // SolverState::key() -> index into states and results
+    vector<SolverResult> results;
+
+    // False if the story has too many scenes for the state key.
+    bool load(const Story& source) {
+        story.buildBfs(source);
+        if (story.nodes.size() > SOLVER_MAX_SLOTS) return false;
+        pickups = storyPickups();
+        if ((int)pickups.size() > SOLVER_MAX_PICKUPS) pickups.resize(SOLVER_MAX_PICKUPS);
+        pickupEffect.clear();
+        for (const Pickup& p : pickups) pickupEffect.push_back(itemEffect(p.type, p.effect));
+        pickupAt.assign(story.nodes.size(), -1);
+        survivesAt.assign(story.nodes.size(), 0);
+        for (int s = 0; s < (int)story.nodes.size(); s++) {
+            for (int i = 0; i < (int)pickups.size(); i++)
+                if (pickups[i].nodeId == story.nodes[s].id) pickupAt[s] = i;
+            survivesAt[s] = isSurvivalEnding(story.text[s].description);
+        }
+        return true;
+    }
+
+    bool terminal(const SolverState& s) const {
+        const PackedNode& n = story.nodes[s.slot];
+        return isDeath(s.health, s.hunger, s.energy) || (n.flags & NODE_ENDING) || (n.left < 0 && n.right < 0);
+    }
+
+    double terminalValue(const SolverState& s) const {
+        if (isDeath(s.health, s.hunger, s.energy)) return 0;
+        return (story.nodes[s.slot].flags & NODE_ENDING) && survivesAt[s.slot] ? 1 : 0;
+    }
+
+    // Mirrors useItem, uses[i] times per pickup, in pickup order.
+    SolverState use(SolverState s, const int uses[]) const {
+        for (int i = 0; i < (int)pickups.size(); i++)
+            for (int k = 0; k < uses[i]; k++) {
+                s.held[i]--;
+                s = s.after(pickupEffect[i]);
+            }
+        return s;
+    }
+
+    // Calls f(uses) for every way of using what s holds, none first.
+    template <class F>
+    void forEachUse(const SolverState& s, F f) const {
+        int uses[SOLVER_MAX_PICKUPS] = {};
+        int n = (int)pickups.size();
+        for (;;) {
+            f((const int*)uses);
+            int i = 0;
+            while (i < n && uses[i] == s.held[i]) uses[i++] = 0;
+            if (i == n) return;
+            uses[i]++;
+        }
+    }
+
+    // Mirrors makeChoice: move, pay energy, grow hungry, pick up, maybe a storm.
+    int step(SolverState s, int choice, Outcome out[2]) const {
+        const PackedNode& n = story.nodes[s.slot];
+        int to = choice == 1 ? n.left : n.right;
+        if (to < 0) return 0;
+        s.slot = to;
+        if (pickupAt[to] >= 0) s.held[pickupAt[to]] = min(SOLVER_MAX_HELD, s.held[pickupAt[to]] + 1);
+
+        Effect turn = TURN_EFFECT;
+        turn += MOVE_EFFECT[choice - 1];
+        double storm = SNOWSTORM_CHANCE / 100.0;
+        out[0] = {s.after(turn), 1 - storm};
+        turn += SNOWSTORM.effect;
+        out[1] = {s.after(turn), storm};
+        return 2;
+    }
+
+    // Every state reachable from the start under any policy.
+    void explore(const SolverState& start) {
+        states.clear();
+        indexOf.clear();
+        add(start);
+        for (size_t i = 0; i < states.size(); i++) {
+            SolverState s = states[i];
+            if (terminal(s)) continue;
+            forEachUse(s, [&](const int* uses) {
+                SolverState ready = use(s, uses);
+                for (int c = 1; c <= 2; c++) {
+                    Outcome out[2];
+                    int k = step(ready, c, out);
+                    for (int j = 0; j < k; j++) add(out[j].next);
+                }
+            });
+        }
+    }
+
+    // Every move costs energy, so a state only leads to states with less
+    // energy: one sweep from low energy to high is exact. States with the
+    // same energy are independent and are split across threads.
+    void solve(int threads = (int)thread::hardware_concurrency()) {
+        threads = max(1, threads);
+        results.assign(states.size(), SolverResult());
+        vector<vector<int>> byEnergy(101);
+        for (int i = 0; i < (int)states.size(); i++) byEnergy[max(0, min(100, states[i].energy))].push_back(i);
+
+        for (const vector<int>& layer : byEnergy) {
+            if (layer.empty()) continue;
+            atomic<size_t> nextIndex{0};
+            auto work = [&] {
+                size_t i;
+                while ((i = nextIndex.fetch_add(64)) < layer.size())
+                    for (size_t j = i; j < min(layer.size(), i + 64); j++) evaluate(layer[j]);
+            };
+            int n = (int)min<size_t>(threads, (layer.size() + 63) / 64);
+            vector<thread> pool;
+            for (int t = 1; t < n; t++) pool.emplace_back(work);
+            work();
+            for (thread& t : pool) t.join();
+        }
+    }
+
+    const SolverResult* lookup(const SolverState& s) const {
+        int i;
+        return indexOf.find(s.key(), i) ? &results[i] : nullptr;
+    }
+
+    SolverState startState(const Wolf& w) const {
+        SolverState s{0, w.health, w.hunger, w.energy, {0}};
+        return s;
+    }
+
+private:
+    void add(const SolverState& s) {
+        int next = (int)states.size();
+        if (indexOf.findOrAdd(s.key(), [&] { return next; }) == next) states.push_back(s);
+    }
+
+    // Every non-terminal successor was added by explore().
+    double valueOf(const SolverState& s) const {
+        return terminal(s) ? terminalValue(s) : lookup(s)->survival;
+    }
+
+    void evaluate(int index) {
+        const SolverState& s = states[index];
+        SolverResult& r = results[index];
+        if (terminal(s)) { r.survival = terminalValue(s); r.choiceValue[0] = r.choiceValue[1] = -1; return; }
+
+        r.survival = -1;
+        r.choiceValue[0] = r.choiceValue[1] = -1;
+        forEachUse(s, [&](const int* uses) {
+            SolverState ready = use(s, uses);
+            for (int c = 1; c <= 2; c++) {
+                Outcome out[2];
+                int k = step(ready, c, out);
+                if (k == 0) continue;
+                double v = 0;
+                for (int j = 0; j < k; j++) v += out[j].probability * valueOf(out[j].next);
+                r.choiceValue[c - 1] = max(r.choiceValue[c - 1], v);
+                if (v > r.survival) {
+                    r.survival = v;
+                    r.choice = c;
+                    copy(uses, uses + SOLVER_MAX_PICKUPS, r.uses);
+                }
+            }
+        });
+        r.survival = max(0.0, r.survival);
+    }
+};
+
+#endif
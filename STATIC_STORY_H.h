@@ -0,0 +1,158 @@
+#ifndef STATIC_STORY_H
+#define STATIC_STORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include "RULES_H.h"
+
+using namespace std;
+
+// --- STATIC SCENES ---
+// A story compiled into the binary: STORY_TABLE_H.h is generated from
+// story_edges.txt + scenarios.txt by StoryCodegen.cpp. Scenes and their
+// text live in read-only data, so nothing is parsed or allocated at startup.
+// Choices name scene ids (0 = no choice), as in story_edges.txt, so the
+// checks below can name what is wrong; linkStory then resolves them to the
+// slots StoryNode uses. Slot 0 is the opening scene.
+struct StaticScene {
+    int id;
+    const char* description;
+    const char* choiceA;
+    const char* choiceB;
+    int left;
+    int right;
+    bool isEnding;   // from the "ENDING" heading in scenarios.txt
+};
+
+template <size_t N>
+constexpr int staticSlot(const StaticScene (&s)[N], int id) {
+    for (size_t i = 0; i < N; i++)
+        if (s[i].id == id) return (int)i;
+    return -1;
+}
+
+template <size_t N>
+constexpr int storyIdLimit(const StaticScene (&s)[N]) {
+    int limit = 1;
+    for (size_t i = 0; i < N; i++) limit = max(limit, s[i].id + 1);
+    return limit;
+}
+
+// The scenes as engine StoryNodes, choices resolved to slots and the id
+// index filled in, all at compile time. story() is what sessions play.
+template <size_t N, int IDS>
+struct StaticStoryTable {
+    StoryNode nodes[N];
+    int slotOfId[IDS];
+
+    constexpr Story story() const { return {nodes, (int)N, slotOfId, IDS}; }
+};
+
+template <int IDS, size_t N>
+constexpr StaticStoryTable<N, IDS> linkStory(const StaticScene (&s)[N]) {
+    StaticStoryTable<N, IDS> t{};
+    for (int id = 0; id < IDS; id++) t.slotOfId[id] = -1;
+    for (size_t i = 0; i < N; i++) {
+        t.nodes[i] = {s[i].id, s[i].description, s[i].choiceA, s[i].choiceB,
+                      s[i].left ? staticSlot(s, s[i].left) : -1,
+                      s[i].right ? staticSlot(s, s[i].right) : -1, s[i].isEnding};
+        if (s[i].id > 0 && s[i].id < IDS) t.slotOfId[s[i].id] = (int)i;
+    }
+    return t;
+}
+
+// --- COMPILE-TIME CHECKS ---
+// Each is static_assert-ed by the generated table, so a broken story stops
+// the build with a message instead of crashing a kiosk mid-game.
+template <size_t N>
+constexpr bool storyIdsUnique(const StaticScene (&s)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (s[i].id <= 0) return false;
+        for (size_t j = i + 1; j < N; j++)
+            if (s[i].id == s[j].id) return false;
+    }
+    return true;
+}
+
+// Every choice names a scene that exists.
+template <size_t N>
+constexpr bool storyEdgesResolve(const StaticScene (&s)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (s[i].left && staticSlot(s, s[i].left) < 0) return false;
+        if (s[i].right && staticSlot(s, s[i].right) < 0) return false;
+    }
+    return true;
+}
+
+// Endings have no choices; every other scene has both, with text for each.
+template <size_t N>
+constexpr bool storyChoicesComplete(const StaticScene (&s)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (s[i].isEnding) {
+            if (s[i].left || s[i].right) return false;
+        } else {
+            if (!s[i].left || !s[i].right || !s[i].choiceA[0] || !s[i].choiceB[0]) return false;
+        }
+    }
+    return true;
+}
+
+// No loop without a way out: every scene can still reach some ending.
+template <size_t N>
+constexpr bool storyAlwaysEnds(const StaticScene (&s)[N]) {
+    bool ends[N] = {};
+    for (size_t i = 0; i < N; i++) ends[i] = s[i].isEnding;
+    for (size_t round = 0; round < N; round++) {
+        bool changed = false;
+        for (size_t i = 0; i < N; i++) {
+            if (ends[i]) continue;
+            int l = s[i].left ? staticSlot(s, s[i].left) : -1;
+            int r = s[i].right ? staticSlot(s, s[i].right) : -1;
+            if ((l >= 0 && ends[l]) || (r >= 0 && ends[r])) { ends[i] = true; changed = true; }
+        }
+        if (!changed) break;
+    }
+    for (size_t i = 0; i < N; i++)
+        if (!ends[i]) return false;
+    return true;
+}
+
+// --- STATIC STORY ---
+// Plays a story through the engine's own turn (playTurn in RULES_H.h) with
+// only the fixed snowstorm odds: no pack, undo or world, so nothing is
+// allocated. A kiosk only needs the walk itself.
+struct StaticStory {
+    const Story* story;
+    const StoryNode* current;
+    Wolf player;
+    bool eventActive = false;
+    uint64_t rngState = 1;
+
+    explicit constexpr StaticStory(const Story& s) : story(&s), current(s.root()) {}
+
+    // Back to the opening scene. Touches only this struct.
+    void init(uint64_t seed) {
+        current = story->root();
+        player = Wolf();
+        eventActive = false;
+        rngState = seed ? seed : 1;
+    }
+
+    const StoryNode& scene() const { return *current; }
+    bool isEnding() const { return current->isEnding; }
+
+    // 1 = choice A, 2 = choice B.
+    void choose(int choice) { playTurn(*this, choice); }
+
+    // playTurn hooks
+    void beforeTurn() {}
+    void entered() {}
+    void rollEvents(Effect& turn, bool) {
+        if (rollPercent(rngState) < SNOWSTORM_CHANCE) {
+            eventActive = true;
+            turn += SNOWSTORM_EFFECT;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef STORY_GEN_H
+#define STORY_GEN_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include "STORY_LAYOUT_H.h"
+
+using namespace std;
+
+// --- PROCEDURAL STORIES ---
+// Same seed + same params = same story on every platform (no rand(), no
+// std distributions). Scene ids run 1..nodes and scene 1 opens the story.
+struct GenParams {
+    int nodes = 1000;
+    uint64_t seed = 1;
+    double depth = 0.0;      // 0 = expand breadth-first (wide), 1 = depth-first (long chains)
+    double endings = 0.2;    // fraction of scenes that are endings
+    double converge = 0.5;   // rejoining choice goes to a shared hub scene (like n9)
+    double cycles = 0.05;    // rejoining choice loops back to an earlier scene
+};
+
+struct GenRng {
+    uint64_t s;
+    uint64_t next() {   // splitmix64
+        uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+    int below(int n) { return n > 0 ? (int)(next() % (uint64_t)n) : 0; }
+};
+
+struct GenStory {
+    vector<int> left, right;   // by id, 0 = no choice (index 0 unused)
+    vector<char> ending;
+    int size() const { return (int)left.size() - 1; }
+};
+
+inline GenStory generateStory(const GenParams& p) {
+    int n = max(1, p.nodes);
+    GenRng rng{p.seed};
+    GenStory g;
+    g.left.assign(n + 1, 0);
+    g.right.assign(n + 1, 0);
+    g.ending.assign(n + 1, 0);
+
+    int endingsLeft = n == 1 ? 1 : max(1, min(n - 1, (int)(p.endings * n + 0.5)));
+    int nonEndingsLeft = n - endingsLeft;
+    int nextFresh = 2;
+    vector<int> hubs = {1};
+    vector<int> endingIds;
+    deque<int> frontier = {1};
+
+    // A choice that does not open a new scene: back into the story (cycle),
+    // onto a hub, or onto any scene already created further along. Never
+    // onto avoid, the scene the other choice already leads to.
+    auto pick = [&](int u) {
+        int created = nextFresh - 1;
+        if (u > 1 && rng.unit() < p.cycles) return 1 + rng.below(u - 1);
+        if (rng.unit() < p.converge) {
+            int h = hubs[hubs.size() - 1 - rng.below(min<int>(4, hubs.size()))];
+            if (h > u) return h;
+        }
+        if (created > u) return u + 1 + rng.below(created - u);
+        if (!endingIds.empty()) return endingIds[rng.below(endingIds.size())];
+        return 1 + rng.below(created);
+    };
+    auto rejoin = [&](int u, int avoid) {
+        for (int tries = 0; tries < 4; tries++) {
+            int v = pick(u);
+            if (v != avoid) return v;
+        }
+        // Unlucky draws: the next scene after avoid, wrapping. There are at
+        // least two (u is not an ending, so the story has more than one).
+        return avoid % (nextFresh - 1) + 1;
+    };
+    auto fresh = [&]() {
+        int id = nextFresh++;
+        frontier.push_back(id);
+        if (rng.below(64) == 0) hubs.push_back(id);
+        return id;
+    };
+
+    while (!frontier.empty()) {
+        int u;
+        if (rng.unit() < p.depth) { u = frontier.back(); frontier.pop_back(); }
+        else { u = frontier.front(); frontier.pop_front(); }
+
+        int freshLeft = n - nextFresh + 1;
+        bool mustOpen = frontier.empty() && freshLeft > 0;
+        bool isEnd;
+        if ((u == 1 && n > 1) || mustOpen) isEnd = false;
+        else if (nonEndingsLeft <= 0) isEnd = true;
+        else if (endingsLeft <= 0) isEnd = false;
+        else isEnd = rng.below(endingsLeft + nonEndingsLeft) < endingsLeft;
+
+        if (isEnd) {
+            g.ending[u] = 1;
+            endingIds.push_back(u);
+            endingsLeft--;
+            continue;
+        }
+        nonEndingsLeft--;
+
+        // Choice A opens a scene while any are left; choice B opens one as
+        // often as needed to place every scene by the last non-ending.
+        g.left[u] = freshLeft > 0 ? fresh() : rejoin(u, 0);
+        freshLeft = n - nextFresh + 1;
+        double extra = nonEndingsLeft > 0 ? (double)(freshLeft - nonEndingsLeft) / (nonEndingsLeft + 1) : 1.0;
+        if (freshLeft > 0 && rng.unit() < extra) g.right[u] = fresh();
+        else g.right[u] = rejoin(u, g.left[u]);
+    }
+    return g;
+}
+
+// Empty if the story is well formed: every scene reachable from scene 1,
+// endings without choices, and every other scene with two different ones.
+inline string checkStory(const GenStory& g) {
+    int n = g.size();
+    vector<char> seen(n + 1, 0);
+    vector<int> stack = {1};
+    seen[1] = 1;
+    while (!stack.empty()) {
+        int u = stack.back();
+        stack.pop_back();
+        if (g.ending[u] ? g.left[u] || g.right[u] : g.left[u] == g.right[u] || !g.left[u] || !g.right[u])
+            return "scene " + to_string(u) + ": choices " + to_string(g.left[u]) + " / " + to_string(g.right[u]);
+        for (int v : {g.left[u], g.right[u]})
+            if (v && !seen[v]) { seen[v] = 1; stack.push_back(v); }
+    }
+    for (int id = 1; id <= n; id++)
+        if (!seen[id]) return "scene " + to_string(id) + " is unreachable";
+    return "";
+}
+
+// --- TEXT ---
+inline string genTitle(int id) {
+    static const char* places[] = {"Ridge", "Hollow", "Stream", "Clearing", "Pass", "Thicket", "Den", "Shore"};
+    static const char* moods[] = {"Frozen", "Silent", "Burning", "Hidden", "Broken", "Distant", "Bitter", "Pale"};
+    GenRng r{(uint64_t)id};
+    return string(moods[r.below(8)]) + " " + places[r.below(8)];
+}
+
+inline string genLine(int id) {
+    static const char* lines[] = {
+        "Snow drifts across the path as the wind turns.",
+        "Fresh tracks cross older ones, heading north.",
+        "The smell of smoke hangs low between the trees.",
+        "Something moves at the edge of sight and is gone.",
+    };
+    return lines[(unsigned)id * 2654435761u % 4];
+}
+
+// Edge list, the format StoryLayout::loadEdges reads.
+inline bool writeEdges(const GenStory& g, const string& path) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    fprintf(f, "# Generated story: id left right (0 = no choice).\n");
+    for (int id = 1; id <= g.size(); id++) fprintf(f, "%d %d %d\n", id, g.left[id], g.right[id]);
+    return fclose(f) == 0;
+}
+
+// scenarios.txt format; endings carry explicit ids since they are interleaved.
+inline bool writeScenarios(const GenStory& g, const string& path) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    for (int id = 1; id <= g.size(); id++) {
+        if (g.ending[id]) {
+            fprintf(f, "ENDING %d: The %s\n\n%s\n\n", id, genTitle(id).c_str(), genLine(id).c_str());
+        } else {
+            fprintf(f, "SCENE %d: %s\n\n%s\n\nChoice A: Go toward scene %d\nChoice B: Go toward scene %d\n\n",
+                    id, genTitle(id).c_str(), genLine(id).c_str(), g.left[id], g.right[id]);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+// As a playable story: scene id - 1 is its slot, so scene 1 opens it.
+inline OwnedStory buildStory(const GenStory& g) {
+    OwnedStory story;
+    for (int id = 1; id <= g.size(); id++) {
+        bool ending = g.ending[id];
+        story.add(id, make_shared<const ColdText>(ColdText{genTitle(id) + "\n" + genLine(id), ending ? "" : "Go on",
+                                                           ending ? "" : "Turn back"}),
+                  g.left[id] - 1, g.right[id] - 1, ending);
+    }
+    story.link();
+    return story;
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef STORY_LAYOUT_H
+#define STORY_LAYOUT_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include "RULES_H.h"
+
+using namespace std;
+
+// --- HOT / COLD SPLIT ---
+// Topology only: 16 bytes per scene, so a walk touches one cache line per
+// four hops instead of a StoryNode full of text views.
+const uint32_t NODE_ENDING = 1;
+
+struct PackedNode {
+    int32_t id;
+    int32_t left;    // slot of choice A, -1 if none
+    int32_t right;   // slot of choice B, -1 if none
+    uint32_t flags;
+};
+static_assert(sizeof(PackedNode) == 16, "PackedNode must stay 16 bytes");
+
+// Text is only needed when a scene is shown, so it lives apart.
+struct ColdText {
+    string description;
+    string choiceA;
+    string choiceB;
+};
+
+// --- OWNED STORIES ---
+// A story built at run time (loaded or generated) owns its scenes, the id
+// index and the text the scenes' views point into. Text is held per scene,
+// so a newer version can share an unchanged scene's text with the one
+// before it (STORY_RELOAD_H.h). story is the view sessions play; it points
+// into the vectors, so an OwnedStory is moved, never copied.
+struct OwnedStory {
+    vector<StoryNode> nodes;
+    vector<int> slotOfId;
+    vector<shared_ptr<const ColdText>> text;   // same slot order as nodes
+    Story story;
+
+    OwnedStory() = default;
+    OwnedStory(OwnedStory&&) = default;
+    OwnedStory& operator=(OwnedStory&&) = default;
+    OwnedStory(const OwnedStory&) = delete;
+    OwnedStory& operator=(const OwnedStory&) = delete;
+
+    // Appends a scene. Choices are slots (-1 = none) and may name scenes
+    // that are added later.
+    void add(int id, shared_ptr<const ColdText> t, int left, int right, bool ending) {
+        nodes.push_back({id, t->description, t->choiceA, t->choiceB, left, right, ending});
+        text.push_back(move(t));
+    }
+
+    // Builds the id index and the view once every scene is in. Ids index an
+    // array, so a story whose ids are negative or far sparser than its scene
+    // count is refused.
+    bool link() {
+        int limit = 1;
+        for (const StoryNode& n : nodes) {
+            if (n.id < 0 || n.id > 16 * (int)nodes.size() + 1024) return false;
+            limit = max(limit, n.id + 1);
+        }
+        slotOfId.assign(limit, -1);
+        for (int i = 0; i < (int)nodes.size(); i++) slotOfId[nodes[i].id] = i;
+        story = {nodes.data(), (int)nodes.size(), slotOfId.data(), limit};
+        return true;
+    }
+};
+
+struct StoryLayout {
+    vector<PackedNode> nodes;   // slot 0 is always the root
+    vector<ColdText> text;      // same slot order as nodes
+    unordered_map<int, int> slotOfId;
+
+    // Breadth-first from the root: a scene and its choices end up close together.
+    void buildBfs(const Story& story) {
+        build(story, collectBfs(story));
+    }
+
+    // Most visited scenes first, BFS order breaks ties. visits[id] comes from a
+    // profiling run (ids outside the vector count as never visited).
+    void buildByFrequency(const Story& story, const vector<uint64_t>& visits) {
+        vector<int> order = collectBfs(story);
+        auto count = [&](int slot) -> uint64_t {
+            int id = story.nodes[slot].id;
+            return (id >= 0 && id < (int)visits.size()) ? visits[id] : 0;
+        };
+        stable_sort(order.begin() + 1, order.end(), [&](int a, int b) { return count(a) > count(b); });
+        build(story, order);
+    }
+
+    // Topology only, straight from an edge list ("id left right", 0 = none,
+    // '#' comments). Text stays on disk; see STORY_TEXT_H.h.
+    bool loadEdges(const string& path) {
+        ifstream file(path);
+        if (!file.is_open()) return false;
+        vector<int> ids, lefts, rights;
+        string line;
+        while (getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            istringstream in(line);
+            int id, l, r;
+            if (in >> id >> l >> r) { ids.push_back(id); lefts.push_back(l); rights.push_back(r); }
+        }
+        nodes.assign(ids.size(), PackedNode());
+        text.clear();
+        slotOfId.clear();
+        for (int i = 0; i < (int)ids.size(); i++) slotOfId[ids[i]] = i;
+        for (int i = 0; i < (int)ids.size(); i++) {
+            nodes[i].id = ids[i];
+            nodes[i].left = lefts[i] ? find(lefts[i]) : -1;
+            nodes[i].right = rights[i] ? find(rights[i]) : -1;
+            nodes[i].flags = (!lefts[i] && !rights[i]) ? NODE_ENDING : 0;
+        }
+        return true;
+    }
+
+    int find(int id) const {
+        auto it = slotOfId.find(id);
+        return it == slotOfId.end() ? -1 : it->second;
+    }
+
+    const PackedNode& node(int slot) const { return nodes[slot]; }
+    const ColdText& scene(int slot) const { return text[slot]; }
+
+private:
+    // Slots of the story reachable from its root, breadth-first.
+    static vector<int> collectBfs(const Story& story) {
+        vector<int> order;
+        if (!story.count) return order;
+        vector<char> seen(story.count, 0);
+        order.push_back(0);
+        seen[0] = 1;
+        for (size_t i = 0; i < order.size(); i++) {
+            const StoryNode& n = story.nodes[order[i]];
+            for (int k : {n.left, n.right})
+                if (k >= 0 && !seen[k]) { seen[k] = 1; order.push_back(k); }
+        }
+        return order;
+    }
+
+    void build(const Story& story, const vector<int>& order) {
+        nodes.assign(order.size(), PackedNode());
+        text.assign(order.size(), ColdText());
+        slotOfId.clear();
+        vector<int> slotOf(story.count, -1);
+        for (int i = 0; i < (int)order.size(); i++) slotOf[order[i]] = i;
+
+        for (int i = 0; i < (int)order.size(); i++) {
+            const StoryNode& n = story.nodes[order[i]];
+            nodes[i].id = n.id;
+            nodes[i].left = n.left < 0 ? -1 : slotOf[n.left];
+            nodes[i].right = n.right < 0 ? -1 : slotOf[n.right];
+            nodes[i].flags = n.isEnding ? NODE_ENDING : 0;
+            text[i] = {string(n.description), string(n.choiceA), string(n.choiceB)};
+            slotOfId[n.id] = i;
+        }
+    }
+};
+
+#endif
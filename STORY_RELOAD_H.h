@@ -0,0 +1,227 @@
+#ifndef STORY_RELOAD_H
+#define STORY_RELOAD_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <string_view>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include "GAME_ENGINE_H.h"
+#include "STORY_TEXT_H.h"
+
+using namespace std;
+
+// --- IMMUTABLE STORY VERSIONS ---
+// A published version is never modified. Its StoryNodes link only to slots
+// of the same version, so a session can keep using one while a newer one is
+// being built and published next to it. Text is shared per scene: a scene
+// whose bytes did not change keeps the parsed text of the version before.
+struct StoryVersion {
+    int version = 0;
+    OwnedStory scenes;
+    shared_ptr<const string> scenarios;   // scenarios.txt as read
+    vector<string_view> source;           // by slot: the scene's bytes in scenarios
+
+    const Story& story() const { return scenes.story; }
+};
+
+struct ReloadStats {
+    int changed = 0;   // text or choices differ
+    int added = 0;
+    int removed = 0;
+    int parsed = 0;    // scenes whose text was parsed again
+    bool published = false;
+};
+
+struct StoryLibrary {
+    string edgesPath;
+    string scenariosPath;
+    shared_ptr<const StoryVersion> published;   // read with atomic_load
+    mutex reloadLock;                           // one reload at a time
+
+    StoryLibrary(string edges, string scenarios) : edgesPath(edges), scenariosPath(scenarios) {}
+
+    shared_ptr<const StoryVersion> current() const { return atomic_load(&published); }
+
+    // Re-reads the edge list and diffs it against the published version by
+    // scene id. scenarios.txt is read only if textChanged or a new scene needs
+    // text, and then only scenes whose bytes differ are parsed; the rest share
+    // the published text. A new version is published only if something changed.
+    //
+    // Cost: parsing text is proportional to the changed scenes, but reading
+    // both files, comparing every scene's bytes and linking the new version
+    // are proportional to the story. Sessions never wait on any of it.
+    ReloadStats reload(bool textChanged = true) {
+        lock_guard<mutex> guard(reloadLock);
+        ScopedTimer timing(T_LOAD);
+        ReloadStats stats;
+        StoryLayout topology;
+        if (!topology.loadEdges(edgesPath) || topology.nodes.empty())
+            return stats;   // half-written file: keep serving the old version
+
+        shared_ptr<const StoryVersion> old = current();
+        bool readText = textChanged || !old;
+        for (int i = 0; !readText && i < (int)topology.nodes.size(); i++)
+            if (!old->story().find(topology.nodes[i].id)) readText = true;
+        StoryIndex index;
+        auto next = make_shared<StoryVersion>();
+        next->version = old ? old->version + 1 : 1;
+        next->scenarios = old ? old->scenarios : nullptr;
+        if (readText) {
+            auto bytes = make_shared<string>();
+            if (!readWhole(scenariosPath, *bytes) || !index.attach(bytes->data(), bytes->size())) return stats;
+            next->scenarios = move(bytes);
+        }
+        for (const PackedNode& p : topology.nodes) {
+            const StoryNode* was = old ? old->story().find(p.id) : nullptr;
+            int wasSlot = was ? old->story().slotOf(was) : -1;
+            string_view bytes = readText ? sceneBytes(index, p.id) : old->source[wasSlot];
+            shared_ptr<const ColdText> text;
+            if (was && old->source[wasSlot] == bytes) text = old->scenes.text[wasSlot];
+            else { text = make_shared<const ColdText>(index.load(p.id)); stats.parsed++; }
+            next->source.push_back(bytes);
+            next->scenes.add(p.id, move(text), p.left, p.right, p.flags & NODE_ENDING);
+        }
+        if (!next->scenes.link()) return stats;
+
+        for (int slot = 0; slot < next->story().count; slot++) {
+            const StoryNode* was = old ? old->story().find(next->story().nodes[slot].id) : nullptr;
+            if (!was) stats.added++;
+            else if (!sameScene(*old, old->story().slotOf(was), *next, slot)) stats.changed++;
+        }
+        if (old)
+            for (const StoryNode& n : old->scenes.nodes)
+                if (!next->story().find(n.id)) stats.removed++;
+
+        if (old && stats.changed == 0 && stats.added == 0 && stats.removed == 0) return stats;
+        atomic_store(&published, shared_ptr<const StoryVersion>(next));
+        stats.published = true;
+        return stats;
+    }
+
+private:
+    // Into next->scenarios, which the index was attached to.
+    static string_view sceneBytes(const StoryIndex& index, int id) {
+        if (!index.has(id)) return string_view();
+        return string_view(index.base + index.spanOfId[id].offset, index.spanOfId[id].length);
+    }
+
+    static int childId(const Story& s, int slot) { return slot < 0 ? 0 : s.nodes[slot].id; }
+
+    static bool sameScene(const StoryVersion& va, int a, const StoryVersion& vb, int b) {
+        const StoryNode& x = va.story().nodes[a];
+        const StoryNode& y = vb.story().nodes[b];
+        return va.scenes.text[a] == vb.scenes.text[b] && x.isEnding == y.isEnding &&
+               childId(va.story(), x.left) == childId(vb.story(), y.left) &&
+               childId(va.story(), x.right) == childId(vb.story(), y.right);
+    }
+};
+
+// --- FILE WATCHER ---
+// Watches the story directory (editors usually save by rename, which a
+// watch on the file itself would miss) and reloads when either file lands.
+struct StoryWatcher {
+    StoryLibrary& library;
+    atomic<bool> running{false};
+    thread worker;
+    int fd = -1;
+
+    explicit StoryWatcher(StoryLibrary& lib) : library(lib) {}
+    ~StoryWatcher() { stop(); }
+
+    bool start(const string& directory) {
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) return false;
+        if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        running = true;
+        worker = thread([this] { loop(); });
+        return true;
+    }
+
+    void stop() {
+        running = false;
+        if (worker.joinable()) worker.join();
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+
+private:
+    static string baseName(const string& path) {
+        size_t slash = path.find_last_of('/');
+        return slash == string::npos ? path : path.substr(slash + 1);
+    }
+
+    void loop() {
+        string edges = baseName(library.edgesPath), scenes = baseName(library.scenariosPath);
+        alignas(inotify_event) char buf[4096];
+        while (running) {
+            pollfd p = {fd, POLLIN, 0};
+            if (poll(&p, 1, 200) <= 0) continue;
+
+            bool edgesTouched = false, scenesTouched = false;
+            auto drain = [&] {
+                ssize_t len;
+                while ((len = read(fd, buf, sizeof(buf))) > 0) {
+                    for (char* at = buf; at < buf + len;) {
+                        inotify_event* e = (inotify_event*)at;
+                        if (e->len && edges == e->name) edgesTouched = true;
+                        if (e->len && scenes == e->name) scenesTouched = true;
+                        at += sizeof(inotify_event) + e->len;
+                    }
+                }
+            };
+            drain();
+            // Writers often save both files back to back; let the burst settle.
+            if (edgesTouched || scenesTouched) {
+                usleep(50 * 1000);
+                drain();
+                library.reload(scenesTouched);
+            }
+        }
+    }
+};
+
+// --- SESSIONS ON A LIVE STORY ---
+// A session stays on the version it pinned until its next turn, then moves
+// to the newest version by scene id (back to the opening scene if its scene
+// was deleted). Undo already restores by id through findNode. A session
+// made before anything was published starts on the first version.
+struct LiveSession {
+    StoryLibrary& library;
+    shared_ptr<const StoryVersion> pinned;
+    GameEngine game;
+
+    explicit LiveSession(StoryLibrary& lib) : library(lib) {
+        pinned = library.current();
+        if (pinned) game.start(pinned->story());   // also hashes the opening state
+    }
+
+    void migrate() {
+        shared_ptr<const StoryVersion> latest = library.current();
+        if (!latest || latest == pinned) return;
+        const StoryNode* same = game.current ? latest->story().find(game.current->id) : nullptr;
+        game.story = &latest->story();
+        game.current = same ? same : game.story->root();
+        if (!same) game.rehashAll();
+        pinned = latest;
+    }
+
+    // False, and no turn taken, while the library has no story published.
+    bool makeChoice(int choice) {
+        migrate();
+        if (!pinned) return false;
+        game.makeChoice(choice);
+        return true;
+    }
+};
+
+#endif
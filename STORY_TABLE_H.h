@@ -0,0 +1,193 @@
+// Generated by StoryCodegen.cpp from story_edges.txt + scenarios.txt. Do not edit:
+// change those files and rerun ./story_codegen.
+#ifndef STORY_TABLE_H
+#define STORY_TABLE_H
+
+#include "STATIC_STORY_H.h"
+
+// --- SCENE TEXT ---
+constexpr char SCENE_1_TEXT[] =
+    "Echoes After the Storm\n"
+    "The storm has passed, but the forest feels lifeless and cold.\n"
+    "Snow blankets the ground, covering familiar paths and memories.\n"
+    "Your pack is gone. Only blood stains and broken branches remain, whispering of loss.";
+constexpr char SCENE_2_TEXT[] =
+    "Frozen Stream\n"
+    "A frozen stream stretches across your path, its surface cracked and uneven.\n"
+    "Cold air bites at your fur as the ice groans under your weight.\n"
+    "One mistake could send you into freezing water.";
+constexpr char SCENE_3_TEXT[] =
+    "Fading Paw Prints\n"
+    "Half-buried paw prints appear ahead, softened by falling snow.\n"
+    "They are old, but they might still lead to life.\n"
+    "Your instincts urge you to decide quickly.";
+constexpr char SCENE_4_TEXT[] =
+    "Cold Wounds\n"
+    "The ice shatters beneath you, plunging your body into freezing water.\n"
+    "Pain spreads instantly as numbness creeps into your limbs.\n"
+    "Blood darkens the snow as you pull yourself free.";
+constexpr char SCENE_5_TEXT[] =
+    "Hunger Without Reward\n"
+    "You follow the scent of prey, but it fades into nothing.\n"
+    "Your stomach growls, reminding you how long it has been since you last ate.\n"
+    "Hunger weighs heavier than the snow on your back.";
+constexpr char SCENE_6_TEXT[] =
+    "Lone Gray Wolf\n"
+    "A gray wolf emerges from the trees, watching you carefully.\n"
+    "Its eyes hold caution rather than aggression.\n"
+    "This meeting could mean alliance… or danger.";
+constexpr char SCENE_7_TEXT[] =
+    "Night Beneath Open Sky\n"
+    "Darkness settles over the forest, bringing unfamiliar sounds and hidden threats.\n"
+    "The cold deepens as stars appear above you.\n"
+    "Sleep could restore your strength — or leave you vulnerable.";
+constexpr char SCENE_8_TEXT[] =
+    "Slow Healing\n"
+    "Time passes slowly as your wounds begin to close.\n"
+    "Every movement sends pain through your body, but rest offers relief.\n"
+    "Patience may save your life.";
+constexpr char SCENE_9_TEXT[] =
+    "Weak Prey\n"
+    "A small rabbit stumbles through the snow, clearly exhausted.\n"
+    "Your muscles tense, sensing an opportunity for food.\n"
+    "This chance may not return.";
+constexpr char SCENE_10_TEXT[] =
+    "Pack Beginnings\n"
+    "Another wolf chooses to walk beside you, matching your pace.\n"
+    "Trust begins to form through shared survival.\n"
+    "Leadership now rests on your shoulders.";
+constexpr char SCENE_11_TEXT[] =
+    "Sudden Ambush\n"
+    "Without warning, claws tear through the silence.\n"
+    "A rival wolf attacks, fighting for survival or dominance.\n"
+    "The forest echoes with snarls.";
+constexpr char SCENE_12_TEXT[] =
+    "Hunter’s Scent\n"
+    "The air carries the sharp scent of metal and smoke.\n"
+    "Human hunters are near, leaving traps and death behind.\n"
+    "Every instinct screams danger.";
+constexpr char SCENE_13_TEXT[] =
+    "Growing Pack\n"
+    "More wolves gather, drawn by strength and survival.\n"
+    "Your pack grows, but so do its needs.\n"
+    "The future depends on your decisions.";
+constexpr char SCENE_14_TEXT[] =
+    "Leadership Challenge\n"
+    "A strong wolf steps forward, challenging your authority.\n"
+    "The pack forms a silent circle, watching closely.\n"
+    "Only one path will define your rule.";
+constexpr char SCENE_15_TEXT[] =
+    "Quiet Crossing\n"
+    "You reach calmer land, untouched by hunters.\n"
+    "The danger fades, but hunger remains.\n"
+    "Rest or movement — both carry consequences.";
+constexpr char SCENE_16_TEXT[] =
+    "ENDING: Killed by Hunters\n"
+    "A sudden gunshot shatters the silence of the forest.\n"
+    "Pain tears through your body as you collapse into the snow.\n"
+    "The hunters never see you as a survivor — only a target.\n"
+    "Your journey ends beneath a sky that offers no mercy.";
+constexpr char SCENE_17_TEXT[] =
+    "ENDING: Alpha of the North\n"
+    "You stand tall at the center of your pack, strong and unchallenged.\n"
+    "Wolves gather around you, their howls echoing through the frozen land.\n"
+    "Under your leadership, the pack thrives, united and fearless.\n"
+    "The north remembers your name as its true alpha.";
+constexpr char SCENE_18_TEXT[] =
+    "ENDING: Lone Wanderer\n"
+    "You choose survival over companionship.\n"
+    "The forest becomes both home and enemy as you walk alone.\n"
+    "No pack follows your trail, only the wind and falling snow.\n"
+    "You live — but solitude becomes your constant companion.";
+constexpr char SCENE_19_TEXT[] =
+    "ENDING: Death by Starvation\n"
+    "Days pass without food, each step weaker than the last.\n"
+    "Your body slowly shuts down as hunger consumes your strength.\n"
+    "The forest remains indifferent to your struggle.\n"
+    "In the end, hunger claims what hope could not save.";
+constexpr char SCENE_20_TEXT[] =
+    "ENDING: Heroic Sacrifice\n"
+    "You face danger head-on, protecting your pack without hesitation.\n"
+    "Claws and blood fill the air as you fight your final battle.\n"
+    "Though your body falls, your bravery saves the others.\n"
+    "Your howl fades, but your sacrifice is never forgotten.";
+constexpr char SCENE_21_TEXT[] =
+    "ENDING: Death in Battle\n"
+    "The fight is brutal and unforgiving.\n"
+    "Snow is stained red as strength drains from your body.\n"
+    "The forest grows silent once more.\n"
+    "You fall as a warrior, defeated but unbroken.";
+constexpr char SCENE_22_TEXT[] =
+    "ENDING: Broken Alpha\n"
+    "You win the challenge through force alone.\n"
+    "The pack obeys, but fear replaces loyalty.\n"
+    "Leadership without trust isolates you from your own wolves.\n"
+    "You stand as alpha — powerful, yet alone.";
+constexpr char SCENE_23_TEXT[] =
+    "ENDING: Peaceful Survival\n"
+    "You choose patience, balance, and restraint.\n"
+    "Life becomes steady, free from constant conflict.\n"
+    "The pack survives quietly, valuing unity over dominance.\n"
+    "Sometimes, survival itself is the greatest victory.";
+constexpr char SCENE_24_TEXT[] =
+    "ENDING: Exhausted Collapse\n"
+    "Your body can no longer carry you forward.\n"
+    "Energy drains away as the cold tightens its grip.\n"
+    "You collapse beneath the open sky, unable to rise again.\n"
+    "The journey ends not in battle, but in complete exhaustion.";
+constexpr char SCENE_25_TEXT[] =
+    "ENDING: Fatal Hunt\n"
+    "Despite weakness, you chase one last chance for food.\n"
+    "Your legs fail, and the prey escapes into the forest.\n"
+    "The cold closes in as strength leaves your body.\n"
+    "A single mistake seals your fate.";
+constexpr char SCENE_26_TEXT[] =
+    "ENDING: Frozen Night\n"
+    "You lie down beneath the stars, seeking rest from endless struggle.\n"
+    "The cold creeps quietly into your bones.\n"
+    "Sleep takes hold — peaceful and final.\n"
+    "Morning never comes.";
+
+// --- SCENES ---
+// id, text, choice A, choice B, A leads to, B leads to, ending
+constexpr StaticScene STORY_SCENES[] = {
+    {1, SCENE_1_TEXT, "Follow the blood scent", "Howl and search your territory", 2, 3, false},
+    {2, SCENE_2_TEXT, "Cross the ice quickly", "Take a longer, safer path", 4, 5, false},
+    {3, SCENE_3_TEXT, "Track the paw prints", "Rest briefly to regain strength", 6, 7, false},
+    {4, SCENE_4_TEXT, "Stop and treat your wounds", "Ignore the pain and push forward", 8, 9, false},
+    {5, SCENE_5_TEXT, "Search desperately for prey", "Rest and conserve energy", 9, 7, false},
+    {6, SCENE_6_TEXT, "Approach calmly", "Avoid and move away", 10, 7, false},
+    {7, SCENE_7_TEXT, "Stay alert through the night", "Sleep despite the risks", 11, 26, false},
+    {8, SCENE_8_TEXT, "Rest longer to heal", "Move on despite the pain", 9, 6, false},
+    {9, SCENE_9_TEXT, "Chase the prey", "Ignore it and save energy", 12, 19, false},
+    {10, SCENE_10_TEXT, "Lead patiently", "Assert dominance", 13, 14, false},
+    {11, SCENE_11_TEXT, "Fight back", "Flee into the forest", 21, 9, false},
+    {12, SCENE_12_TEXT, "Avoid the area", "Investigate the scent", 15, 16, false},
+    {13, SCENE_13_TEXT, "Expand territory", "Focus on feeding the pack", 17, 23, false},
+    {14, SCENE_14_TEXT, "Fight for leadership", "Step aside peacefully", 22, 18, false},
+    {15, SCENE_15_TEXT, "Keep moving", "Rest and recover", 18, 9, false},
+    {16, SCENE_16_TEXT, "", "", 0, 0, true},
+    {17, SCENE_17_TEXT, "", "", 0, 0, true},
+    {18, SCENE_18_TEXT, "", "", 0, 0, true},
+    {19, SCENE_19_TEXT, "", "", 0, 0, true},
+    {20, SCENE_20_TEXT, "", "", 0, 0, true},
+    {21, SCENE_21_TEXT, "", "", 0, 0, true},
+    {22, SCENE_22_TEXT, "", "", 0, 0, true},
+    {23, SCENE_23_TEXT, "", "", 0, 0, true},
+    {24, SCENE_24_TEXT, "", "", 0, 0, true},
+    {25, SCENE_25_TEXT, "", "", 0, 0, true},
+    {26, SCENE_26_TEXT, "", "", 0, 0, true},
+};
+
+static_assert(storyIdsUnique(STORY_SCENES), "story: scene ids must be positive and unique");
+static_assert(storyEdgesResolve(STORY_SCENES), "story: a choice leads to a scene that does not exist");
+static_assert(storyChoicesComplete(STORY_SCENES), "story: endings take no choices, other scenes need both with text");
+static_assert(storyAlwaysEnds(STORY_SCENES), "story: some scenes can never reach an ending");
+
+// --- LINKED ---
+constexpr int STORY_ID_LIMIT = storyIdLimit(STORY_SCENES);
+constexpr StaticStoryTable<sizeof STORY_SCENES / sizeof STORY_SCENES[0], STORY_ID_LIMIT> STORY_TABLE =
+    linkStory<STORY_ID_LIMIT>(STORY_SCENES);
+constexpr Story STORY = STORY_TABLE.story();
+
+#endif
@@ -0,0 +1,279 @@
+#ifndef STORY_TEXT_H
+#define STORY_TEXT_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "STORY_LAYOUT_H.h"
+#include "METRICS_H.h"
+
+using namespace std;
+
+// --- SCENE TEXT ON DISK ---
+// scenarios.txt is memory-mapped and indexed once by heading:
+//   "SCENE <id>: <title>"  a scene, followed by its text and "Choice A:/B:" lines
+//   "ENDING: <title>"      an ending, numbered after the last id seen
+//   "ENDING <id>: <title>" an ending with an explicit id
+// Only byte offsets are kept; a scene is parsed when it is entered. Offsets
+// are 32-bit to keep the index small, so files over 4 GB are refused. The
+// index is dense by id, so a file whose ids are far sparser than its
+// headings is refused too, with the same bound as OwnedStory::link.
+struct TextSpan {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+// The file as it is now, with read(): unlike a mapping, a file an editor
+// truncates meanwhile just reads short instead of faulting. False if it
+// cannot be opened or read.
+inline bool readWhole(const string& path, string& out) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    out.clear();
+    if (fstat(fd, &st) == 0 && st.st_size > 0) out.reserve(st.st_size);
+    char buf[1 << 16];
+    for (;;) {
+        ssize_t got = ::read(fd, buf, sizeof(buf));
+        if (got < 0 && errno == EINTR) continue;
+        if (got < 0) { ::close(fd); return false; }
+        if (got == 0) break;
+        out.append(buf, got);
+    }
+    ::close(fd);
+    return true;
+}
+
+struct StoryIndex {
+    const char* base = nullptr;
+    size_t size = 0;
+    bool mapped = false;         // base is our mapping, not the caller's bytes
+    vector<TextSpan> spanOfId;   // dense by id, length 0 = no text
+
+    StoryIndex() = default;
+    // Owns the mapping: moved, never copied (a copy would unmap it twice).
+    StoryIndex(const StoryIndex&) = delete;
+    StoryIndex& operator=(const StoryIndex&) = delete;
+    StoryIndex(StoryIndex&& o) noexcept : base(o.base), size(o.size), mapped(o.mapped), spanOfId(move(o.spanOfId)) {
+        o.base = nullptr;
+        o.size = 0;
+        o.mapped = false;
+    }
+    StoryIndex& operator=(StoryIndex&& o) noexcept {
+        if (this != &o) {
+            close();
+            base = o.base;
+            size = o.size;
+            mapped = o.mapped;
+            spanOfId = move(o.spanOfId);
+            o.base = nullptr;
+            o.size = 0;
+            o.mapped = false;
+        }
+        return *this;
+    }
+
+    bool open(const string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0 || (uint64_t)st.st_size > UINT32_MAX) { ::close(fd); return false; }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        base = (const char*)p;
+        size = st.st_size;
+        mapped = true;
+        if (!buildIndex()) { close(); return false; }
+        // Indexing touched every page; let the kernel take them back until needed.
+        madvise((void*)base, size, MADV_DONTNEED);
+        return true;
+    }
+
+    // Indexes bytes the caller already holds and keeps alive, such as a
+    // file read whole with readWhole. Nothing is mapped.
+    bool attach(const char* bytes, size_t n) {
+        close();
+        if (n == 0 || n > UINT32_MAX) return false;
+        base = bytes;
+        size = n;
+        if (!buildIndex()) { close(); return false; }
+        return true;
+    }
+
+    void close() {
+        if (base && mapped) munmap((void*)base, size);
+        base = nullptr;
+        size = 0;
+        mapped = false;
+        spanOfId.clear();
+    }
+
+    ~StoryIndex() { close(); }
+
+    // False for every id until open() has succeeded.
+    bool has(int id) const {
+        return base && id >= 0 && id < (int)spanOfId.size() && spanOfId[id].length > 0;
+    }
+
+    // Hint the kernel to start reading a scene's pages now.
+    void prefetch(int id) const {
+        if (!has(id)) return;
+        long page = sysconf(_SC_PAGESIZE);
+        size_t start = spanOfId[id].offset & ~(size_t)(page - 1);
+        size_t end = spanOfId[id].offset + spanOfId[id].length;
+        madvise((void*)(base + start), end - start, MADV_WILLNEED);
+    }
+
+    ColdText load(int id) const {
+        ColdText t;
+        if (!has(id)) return t;
+        const char* p = base + spanOfId[id].offset;
+        const char* end = p + spanOfId[id].length;
+
+        bool first = true;
+        string body;
+        while (p < end) {
+            const char* nl = (const char*)memchr(p, '\n', end - p);
+            if (!nl) nl = end;
+            string line = trim(p, nl);
+            p = nl + 1;
+            if (first) {
+                // Heading: keep only the title after "SCENE n:" / "ENDING:".
+                const char* colon = (const char*)memchr(line.data(), ':', line.size());
+                t.description = colon ? trim(colon + 1, line.data() + line.size()) : line;
+                if (line.compare(0, 6, "ENDING") == 0) t.description = "ENDING: " + t.description;
+                first = false;
+            } else if (line.compare(0, 10, "Choice A: ") == 0) {
+                t.choiceA = line.substr(10);
+            } else if (line.compare(0, 10, "Choice B: ") == 0) {
+                t.choiceB = line.substr(10);
+            } else if (!line.empty() && t.choiceA.empty() && t.choiceB.empty()) {
+                body += "\n" + line;
+            }
+        }
+        t.description += body;
+        return t;
+    }
+
+private:
+    static string trim(const char* b, const char* e) {
+        while (b < e && (*b == ' ' || *b == '\t' || *b == '\r')) b++;
+        while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) e--;
+        return string(b, e);
+    }
+
+    // The id after "SCENE " or "ENDING ", clamped so huge ids are refused, not wrapped.
+    static int headingId(const char* p) {
+        long long id = strtoll(p, nullptr, 10);
+        return id > INT_MAX ? INT_MAX : (int)id;
+    }
+
+    bool buildIndex() {
+        vector<pair<int, TextSpan>> found;
+        int lastId = 0;
+        int openId = -1;
+        size_t openAt = 0;
+        size_t pos = 0;
+        while (pos < size) {
+            const char* line = base + pos;
+            const char* nl = (const char*)memchr(line, '\n', size - pos);
+            size_t len = nl ? (size_t)(nl - line) : size - pos;
+
+            int id = -1;
+            if (len > 6 && memcmp(line, "SCENE ", 6) == 0) {
+                id = headingId(line + 6);
+            } else if (len >= 7 && memcmp(line, "ENDING", 6) == 0 && (line[6] == ':' || line[6] == ' ')) {
+                id = line[6] == ' ' ? headingId(line + 7) : (lastId < INT_MAX ? lastId + 1 : INT_MAX);
+            }
+            if (id > 0) {
+                if (openId > 0) found.push_back({openId, {(uint32_t)openAt, (uint32_t)(pos - openAt)}});
+                openId = id;
+                openAt = pos;
+                lastId = max(lastId, id);
+            }
+            pos += len + 1;
+        }
+        if (openId > 0) found.push_back({openId, {(uint32_t)openAt, (uint32_t)(size - openAt)}});
+
+        int limit = 0;
+        for (const auto& f : found) {
+            if (f.first > 16LL * (long long)found.size() + 1024) return false;
+            limit = max(limit, f.first + 1);
+        }
+        spanOfId.assign(limit, TextSpan());
+        for (const auto& f : found) spanOfId[f.first] = f.second;
+        return true;
+    }
+};
+
+// --- LAZY STORY ---
+// A story GameEngine plays with only its topology resident: the scenes come
+// from story_edges.txt with empty text views, and scenarios.txt stays mapped
+// and indexed. Sessions share it read-only; each reads text through its own
+// LazyText.
+struct LazyStory {
+    OwnedStory scenes;
+    StoryIndex index;
+
+    bool open(const string& edgesPath, const string& scenariosPath) {
+        ScopedTimer timing(T_LOAD);
+        StoryLayout topology;
+        if (!topology.loadEdges(edgesPath) || topology.nodes.empty()) return false;
+        if (!index.open(scenariosPath)) return false;
+        OwnedStory s;
+        auto none = make_shared<const ColdText>();
+        for (const PackedNode& p : topology.nodes) s.add(p.id, none, p.left, p.right, p.flags & NODE_ENDING);
+        if (!s.link()) return false;
+        scenes = move(s);
+        return true;
+    }
+
+    const Story& story() const { return scenes.story; }
+};
+
+// One session's resident text: the scene it is on and the two it can enter
+// next. Call show() with the session's current scene whenever it is shown.
+struct LazyText {
+    const LazyStory& source;
+    unordered_map<int, ColdText> active;   // by id
+
+    explicit LazyText(const LazyStory& s) : source(s) {}
+
+    const ColdText& show(const StoryNode* at) {
+        const Story& story = source.story();
+        int keep[3] = {at->id, childId(story, at->left), childId(story, at->right)};
+
+        for (auto it = active.begin(); it != active.end();) {
+            if (it->first != keep[0] && it->first != keep[1] && it->first != keep[2]) it = active.erase(it);
+            else ++it;
+        }
+        // Start readahead for both choices, parse the scene being shown,
+        // then parse the choices speculatively: one of them is next.
+        for (int i = 1; i < 3; i++)
+            if (keep[i] > 0 && !active.count(keep[i])) source.index.prefetch(keep[i]);
+        for (int k : keep)
+            if (k > 0 && !active.count(k)) active[k] = source.index.load(k);
+        return active[at->id];
+    }
+
+    size_t bytes() const {
+        size_t n = 0;
+        for (const auto& a : active) n += a.second.description.size() + a.second.choiceA.size() + a.second.choiceB.size();
+        return n;
+    }
+
+private:
+    static int childId(const Story& s, int slot) { return slot < 0 ? 0 : s.nodes[slot].id; }
+};
+
+#endif
@@ -0,0 +1,124 @@
+// Many sessions, few of them active, under a memory budget: measures how
+// often sessions are paged out and how long paging one back in takes.
+// Build: g++ -O2 -std=c++17 -pthread SessionBench.cpp -o session_bench
+// Run:   ./session_bench [sessions] [budgetKB] [commands] [dir]
+//        ./session_bench --check [dir]   checks history compaction, save paths and closing
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#include "GAME_ENGINE_H.h"
+#include "SESSIONS_H.h"
+
+using namespace std;
+
+static bool exists(const string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+static int check(const string& dir) {
+    SessionManager manager(dir, 1);   // every session but the one in use goes to disk
+    manager.historyTurns = 4;
+    int failures = 0;
+    auto expect = [&](bool ok, const string& what) {
+        cout << (ok ? "ok    " : "FAIL  ") << what << endl;
+        if (!ok) failures++;
+    };
+    auto ok = [](const string& reply) { return reply.compare(0, 2, "OK") == 0; };
+    auto jump = [&](uint64_t id, int turn) { return manager.handle(id, "jump " + to_string(turn) + "\n"); };
+
+    uint64_t a = manager.create(), b = manager.create();
+    string waits;
+    for (int i = 0; i < 30; i++) waits += "wait\n";   // the stats settle after ~24 distinct turns
+    manager.handle(a, waits);
+    const History& h = manager.sessions[a]->live->history;
+    int turn = h.turn(), base = h.base;
+    expect(turn > 16 && turn - base <= 8 && (int)h.nodes.size() == turn - base + 1,
+           "turn " + to_string(turn) + " keeps turns " + to_string(base) + " on");
+    string newest = manager.handle(a, "status\n");
+    expect(!ok(jump(a, base - 1)) && ok(jump(a, base)), "undo and jump stop at the oldest turn kept");
+    string redo;
+    for (int t = base; t < turn; t++) redo += "redo\n";
+    manager.handle(a, redo);
+    expect(manager.handle(a, "status\n") == newest, "redo walks back to the newest turn");
+
+    manager.handle(b, "1\n");
+    long long pageIns = manager.pageIns;
+    expect(ok(jump(a, base)) && !ok(jump(a, base - 1)) && manager.pageIns == pageIns + 1,
+           "the compacted history survives a page-out");
+
+    manager.handle(a, "save\n");
+    manager.handle(b, "save\n");
+    ifstream saveA(manager.savePath(a)), saveB(manager.savePath(b));
+    int sceneA = 0, sceneB = 0;
+    saveA >> sceneA;
+    saveB >> sceneB;
+    expect(sceneA == 1 && sceneB == 2, "each session saves to its own file");
+    remove(manager.savePath(a).c_str());
+    remove(manager.savePath(b).c_str());
+
+    expect(manager.close(b) && manager.sessionCount() == 1 && !exists(dir + "/" + to_string(b) + ".ses"),
+           "closing a paged-out session drops its entry and its file");
+    expect(manager.handle(b, "status\n") == "ERR no such session\n" && !manager.close(b), "a closed session is gone");
+    for (int i = 0; i < 1000; i++) manager.close(manager.create());
+    expect(manager.sessionCount() == 1, "1000 sessions opened and closed leave the table as it was");
+
+    cout << (failures ? to_string(failures) + " failed" : string("all checks passed")) << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--check") == 0) {
+        string dir = argc > 2 ? argv[2] : "sessions";
+        mkdir(dir.c_str(), 0755);
+        return check(dir);
+    }
+    int count = argc > 1 ? atoi(argv[1]) : 10000;
+    size_t budget = (size_t)(argc > 2 ? atoll(argv[2]) : 32768) * 1024;
+    long long commands = argc > 3 ? atoll(argv[3]) : 200000;
+    string dir = argc > 4 ? argv[4] : "sessions";
+    mkdir(dir.c_str(), 0755);
+
+    SessionManager manager(dir, budget);
+    vector<uint64_t> ids;
+    for (int i = 0; i < count; i++) ids.push_back(manager.create());
+
+    // 90% of commands go to 5% of the sessions; the rest wander back after a while.
+    const char* mix[] = {"1\n", "2\n", "status\n", "undo\n", "inventory\n", "1\nuse Scraps\n"};
+    uint64_t r = 88172645463325252ULL;
+    vector<double> resumeUs, hotUs;
+    auto t0 = chrono::steady_clock::now();
+    for (long long c = 0; c < commands; c++) {
+        r ^= r << 13; r ^= r >> 7; r ^= r << 17;
+        int hot = max(1, count / 20);
+        uint64_t id = ids[(r % 10 < 9) ? (r >> 8) % hot : (r >> 8) % count];
+        long long before = manager.pageIns;
+        auto s = chrono::steady_clock::now();
+        string reply = manager.handle(id, mix[(r >> 40) % 6]);
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - s).count();
+        if (reply.compare(0, 3, "ERR") == 0 && reply.find("unavailable") != string::npos) {
+            cerr << "session " << id << " lost\n";
+            return 1;
+        }
+        (manager.pageIns > before ? resumeUs : hotUs).push_back(us);
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    auto pct = [](vector<double>& v, double q) {
+        if (v.empty()) return 0.0;
+        sort(v.begin(), v.end());
+        return v[min(v.size() - 1, (size_t)(q * v.size()))];
+    };
+    cout << count << " sessions, budget " << budget / 1024 << " KB, " << commands << " commands in " << secs << " s\n";
+    cout << "resident " << manager.residentCount() << " (" << manager.resident / 1024 << " KB), evictions "
+         << manager.evictions << ", page-ins " << manager.pageIns << "\n";
+    cout << "resident command: p50 " << pct(hotUs, 0.5) << " us, p99 " << pct(hotUs, 0.99) << " us\n";
+    cout << "paged-in command: p50 " << pct(resumeUs, 0.5) << " us, p99 " << pct(resumeUs, 0.99) << " us\n";
+    return 0;
+}
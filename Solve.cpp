@@ -0,0 +1,70 @@
+// Optimal-policy solver: best survival chance and the trap choice per scene,
+// for a session with no world attached (snowstorms only, see SOLVER_H.h).
+// Build: g++ -O2 -std=c++17 -pthread Solve.cpp -o solve
+// Run:   ./solve [states.csv]   (the CSV lists every reachable state)
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include "SOLVER_H.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    GameEngine game;
+    game.init();
+
+    Solver solver;
+    if (!solver.load(*game.story)) {
+        cerr << "story too large: the solver handles up to " << SOLVER_MAX_SLOTS << " scenes\n";
+        return 1;
+    }
+    solver.explore(solver.startState(game.player));
+    solver.solve();
+
+    // Per scene: best chance over every way of arriving there, and how the two
+    // choices compare on average. The clearly worse one is the trap.
+    int slots = (int)solver.story.nodes.size();
+    vector<double> best(slots, 0), sum(slots, 0), sumA(slots, 0), sumB(slots, 0);
+    vector<int> count(slots, 0);
+    for (size_t i = 0; i < solver.states.size(); i++) {
+        int s = solver.states[i].slot;
+        const SolverResult& r = solver.results[i];
+        best[s] = max(best[s], r.survival);
+        sum[s] += r.survival;
+        sumA[s] += max(0.0, r.choiceValue[0]);
+        sumB[s] += max(0.0, r.choiceValue[1]);
+        count[s]++;
+    }
+
+    const SolverResult* start = solver.lookup(solver.startState(game.player));
+    cout << "snowstorms only: no world events (hunters, prey, last stretch) or injected events\n";
+    cout << solver.states.size() << " states, survival from the start: "
+         << fixed << setprecision(3) << (start ? start->survival : 0) << "\n\n";
+    cout << "scene  states   best   mean  A(avg)  B(avg)  trap\n";
+    for (int s = 0; s < slots; s++) {
+        if (!count[s] || (solver.story.nodes[s].flags & NODE_ENDING)) continue;
+        double a = sumA[s] / count[s], b = sumB[s] / count[s];
+        string trap = a + 0.01 < b ? "A: " + solver.story.text[s].choiceA
+                    : b + 0.01 < a ? "B: " + solver.story.text[s].choiceB : "-";
+        cout << setw(5) << solver.story.nodes[s].id << setw(8) << count[s] << setw(7) << best[s]
+             << setw(7) << sum[s] / count[s] << setw(8) << a << setw(8) << b << "  " << trap << "\n";
+    }
+
+    if (argc > 1) {
+        ofstream csv(argv[1]);
+        csv << "scene,health,hunger,energy";
+        for (const Pickup& p : solver.pickups) csv << "," << p.name;
+        for (const Pickup& p : solver.pickups) csv << ",use " << p.name;
+        csv << ",choice,survival\n";
+        for (size_t i = 0; i < solver.states.size(); i++) {
+            const SolverState& st = solver.states[i];
+            const SolverResult& r = solver.results[i];
+            csv << solver.story.nodes[st.slot].id << "," << st.health << "," << st.hunger << "," << st.energy;
+            for (size_t p = 0; p < solver.pickups.size(); p++) csv << "," << st.held[p];
+            for (size_t p = 0; p < solver.pickups.size(); p++) csv << "," << r.uses[p];
+            csv << "," << r.choice << "," << r.survival << "\n";
+        }
+    }
+    return 0;
+}
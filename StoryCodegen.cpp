@@ -0,0 +1,117 @@
+// Build-time generator for static stories (STATIC_STORY_H.h): turns the edge
+// list and scene text into a constexpr table header, checked by static_assert.
+// Build: g++ -O2 -std=c++17 StoryCodegen.cpp -o story_codegen
+// Run:   ./story_codegen [story_edges.txt] [scenarios.txt] [STORY_TABLE_H.h]
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "STORY_TEXT_H.h"
+
+using namespace std;
+
+struct EdgeLine {
+    int id, left, right;
+};
+
+// story_edges.txt as written: ids are kept even when they point nowhere,
+// so the generated static_asserts can reject them.
+bool readEdges(const string& path, vector<EdgeLine>& edges) {
+    ifstream file(path);
+    if (!file.is_open()) return false;
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream in(line);
+        EdgeLine e;
+        if (in >> e.id >> e.left >> e.right) edges.push_back(e);
+    }
+    return true;
+}
+
+string literal(const string& s) {
+    string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if (c == '\n') out += "\\n\"\n    \"";   // one source line per text line
+        else if (c == '\t') out += "\\t";
+        else if ((unsigned char)c < 0x20) continue;
+        else out += c;
+    }
+    return out + "\"";
+}
+
+int main(int argc, char** argv) {
+    string edgesPath = argc > 1 ? argv[1] : "story_edges.txt";
+    string textPath = argc > 2 ? argv[2] : "scenarios.txt";
+    string outPath = argc > 3 ? argv[3] : "STORY_TABLE_H.h";
+
+    vector<EdgeLine> edges;
+    if (!readEdges(edgesPath, edges) || edges.empty()) { cerr << "cannot read " << edgesPath << endl; return 1; }
+    StoryIndex index;
+    if (!index.open(textPath)) { cerr << "cannot read " << textPath << endl; return 1; }
+
+    // Problems are reported here, but the table is still written: the
+    // static_asserts are what keep a broken story out of a build.
+    unordered_set<int> known;
+    for (const EdgeLine& e : edges) known.insert(e.id);
+    int warnings = 0;
+    for (const EdgeLine& e : edges) {
+        if (!index.has(e.id)) { cerr << "warning: scene " << e.id << " has no text" << endl; warnings++; }
+        for (int to : {e.left, e.right})
+            if (to && !known.count(to)) { cerr << "warning: scene " << e.id << " leads to missing scene " << to << endl; warnings++; }
+    }
+    unordered_map<int, const EdgeLine*> byId;
+    for (const EdgeLine& e : edges) byId[e.id] = &e;
+    unordered_set<int> reached = {edges[0].id};
+    vector<int> todo = {edges[0].id};
+    while (!todo.empty()) {
+        const EdgeLine* e = byId[todo.back()];
+        todo.pop_back();
+        for (int to : {e->left, e->right})
+            if (to && byId.count(to) && reached.insert(to).second) todo.push_back(to);
+    }
+    for (const EdgeLine& e : edges)
+        if (!reached.count(e.id)) cerr << "note: scene " << e.id << " cannot be reached from scene " << edges[0].id << endl;
+
+    ostringstream out;
+    out << "// Generated by StoryCodegen.cpp from " << edgesPath << " + " << textPath << ". Do not edit:\n"
+        << "// change those files and rerun ./story_codegen.\n"
+        << "#ifndef STORY_TABLE_H\n#define STORY_TABLE_H\n\n#include \"STATIC_STORY_H.h\"\n\n"
+        << "// --- SCENE TEXT ---\n";
+    vector<ColdText> text;
+    for (const EdgeLine& e : edges) {
+        text.push_back(index.load(e.id));
+        out << "constexpr char SCENE_" << e.id << "_TEXT[] =\n    " << literal(text.back().description) << ";\n";
+    }
+    out << "\n// --- SCENES ---\n// id, text, choice A, choice B, A leads to, B leads to, ending\n"
+        << "constexpr StaticScene STORY_SCENES[] = {\n";
+    for (size_t i = 0; i < edges.size(); i++) {
+        const EdgeLine& e = edges[i];
+        bool ending = text[i].description.compare(0, 8, "ENDING: ") == 0;
+        out << "    {" << e.id << ", SCENE_" << e.id << "_TEXT, " << literal(text[i].choiceA) << ", "
+            << literal(text[i].choiceB) << ", " << e.left << ", " << e.right << ", " << (ending ? "true" : "false") << "},\n";
+    }
+    out << "};\n\n"
+        << "static_assert(storyIdsUnique(STORY_SCENES), \"story: scene ids must be positive and unique\");\n"
+        << "static_assert(storyEdgesResolve(STORY_SCENES), \"story: a choice leads to a scene that does not exist\");\n"
+        << "static_assert(storyChoicesComplete(STORY_SCENES), \"story: endings take no choices, other scenes need both with text\");\n"
+        << "static_assert(storyAlwaysEnds(STORY_SCENES), \"story: some scenes can never reach an ending\");\n\n"
+        << "// --- LINKED ---\n"
+        << "constexpr int STORY_ID_LIMIT = storyIdLimit(STORY_SCENES);\n"
+        << "constexpr StaticStoryTable<sizeof STORY_SCENES / sizeof STORY_SCENES[0], STORY_ID_LIMIT> STORY_TABLE =\n"
+        << "    linkStory<STORY_ID_LIMIT>(STORY_SCENES);\n"
+        << "constexpr Story STORY = STORY_TABLE.story();\n\n"
+        << "#endif\n";
+
+    ofstream file(outPath);
+    file << out.str();
+    if (!file) { cerr << "cannot write " << outPath << endl; return 1; }
+    cout << "wrote " << outPath << ": " << edges.size() << " scenes";
+    if (warnings) cout << ", " << warnings << " warnings";
+    cout << endl;
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Deterministic story generator for scaling tests.
+// Build: g++ -O2 -std=c++17 StoryGen.cpp -o story_gen
+// Run:   ./story_gen nodes=1000000 seed=7 depth=0.2 endings=0.2 converge=0.5 cycles=0.05 out=big
+//        writes big_edges.txt (story_edges.txt format) and big_scenarios.txt
+//        ./story_gen nodes=1000 check=500
+//        checks 500 seeds across shapes instead, writing nothing
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include "STORY_GEN_H.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    GenParams p;
+    string out = "generated";
+    int checkSeeds = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == string::npos) { cerr << "expected key=value, got " << arg << endl; return 1; }
+        string key = arg.substr(0, eq), val = arg.substr(eq + 1);
+        if (key == "nodes") p.nodes = atoi(val.c_str());
+        else if (key == "seed") p.seed = strtoull(val.c_str(), nullptr, 10);
+        else if (key == "depth") p.depth = atof(val.c_str());
+        else if (key == "endings") p.endings = atof(val.c_str());
+        else if (key == "converge") p.converge = atof(val.c_str());
+        else if (key == "cycles") p.cycles = atof(val.c_str());
+        else if (key == "out") out = val;
+        else if (key == "check") checkSeeds = atoi(val.c_str());
+        else { cerr << "unknown option " << key << endl; return 1; }
+    }
+
+    if (checkSeeds > 0) {
+        // Every seed with a spread of shapes, including the degenerate ones.
+        static const double shapes[][4] = {   // depth, endings, converge, cycles
+            {0, 0.2, 0.5, 0.05}, {1, 0.2, 0.5, 0.05}, {0.5, 0.9, 1, 1}, {0.5, 0, 1, 0}, {0, 0.5, 0, 1},
+        };
+        int bad = 0;
+        for (int s = 1; s <= checkSeeds; s++)
+            for (const auto& shape : shapes)
+                for (int n : {1, 2, 3, p.nodes}) {
+                    GenParams q = p;
+                    q.seed = s;
+                    q.nodes = n;
+                    q.depth = shape[0], q.endings = shape[1], q.converge = shape[2], q.cycles = shape[3];
+                    string why = checkStory(generateStory(q));
+                    if (!why.empty() && bad++ < 10)
+                        cerr << "seed " << s << " nodes " << n << ": " << why << endl;
+                }
+        cout << checkSeeds << " seeds: " << (bad ? to_string(bad) + " bad stories" : string("every story well formed")) << endl;
+        return bad ? 1 : 0;
+    }
+
+    GenStory g = generateStory(p);
+    string why = checkStory(g);
+    if (!why.empty()) { cerr << "generated a broken story: " << why << endl; return 1; }
+    int endings = 0;
+    for (int id = 1; id <= g.size(); id++) endings += g.ending[id];
+
+    if (!writeEdges(g, out + "_edges.txt") || !writeScenarios(g, out + "_scenarios.txt")) {
+        cerr << "could not write " << out << "_*.txt" << endl;
+        return 1;
+    }
+    cout << g.size() << " scenes, " << endings << " endings -> "
+         << out << "_edges.txt, " << out << "_scenarios.txt" << endl;
+    return 0;
+}
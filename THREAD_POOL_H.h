@@ -0,0 +1,127 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+using namespace std;
+
+// --- WORK-STEALING THREAD POOL ---
+// One deque per worker. A worker runs its own newest task first (cache-warm,
+// depth-first) and steals the oldest task of another worker when it runs
+// dry. Tasks submitted from inside a task stay on that worker's deque.
+struct ThreadPool {
+    struct Queue {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<Queue>> queues;
+    vector<thread> workers;
+    atomic<int> pending{0};
+    atomic<int> queued{0};       // tasks sitting in the deques
+    bool stopping = false;       // under sleepLock
+    atomic<unsigned> nextQueue{0};
+    mutex sleepLock;
+    condition_variable wake, idle;
+
+    explicit ThreadPool(int threads = (int)thread::hardware_concurrency()) {
+        threads = max(1, threads);
+        for (int i = 0; i < threads; i++) queues.emplace_back(new Queue);
+        for (int i = 0; i < threads; i++) workers.emplace_back([this, i] { run(i); });
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (thread& t : workers) t.join();
+    }
+
+    int size() const { return (int)workers.size(); }
+
+    void submit(function<void()> task) {
+        pending++;
+        int q = self().pool == this ? self().index : (int)(nextQueue++ % queues.size());
+        {
+            lock_guard<mutex> guard(queues[q]->lock);
+            queues[q]->tasks.push_back(move(task));
+        }
+        {
+            // Counted under sleepLock so a worker about to sleep sees it.
+            lock_guard<mutex> guard(sleepLock);
+            queued++;
+        }
+        wake.notify_one();
+    }
+
+    // Blocks until every submitted task, including ones they submitted, ran.
+    void wait() {
+        unique_lock<mutex> lk(sleepLock);
+        idle.wait(lk, [this] { return pending.load() == 0; });
+    }
+
+private:
+    struct Self {
+        ThreadPool* pool = nullptr;
+        int index = -1;
+    };
+    static Self& self() {
+        static thread_local Self s;
+        return s;
+    }
+
+    bool take(int i, function<void()>& task) {
+        {
+            Queue& own = *queues[i];
+            lock_guard<mutex> guard(own.lock);
+            if (!own.tasks.empty()) {
+                task = move(own.tasks.back());
+                own.tasks.pop_back();
+                queued--;
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues.size(); k++) {
+            Queue& victim = *queues[(i + k) % queues.size()];
+            lock_guard<mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(int i) {
+        self().pool = this;
+        self().index = i;
+        function<void()> task;
+        while (true) {
+            if (take(i, task)) {
+                task();
+                task = nullptr;
+                if (--pending == 0) {
+                    lock_guard<mutex> guard(sleepLock);
+                    idle.notify_all();
+                }
+                continue;
+            }
+            unique_lock<mutex> lk(sleepLock);
+            if (stopping) return;
+            wake.wait(lk, [this] { return stopping || queued.load() > 0; });
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include "ZOBRIST_H.h"
+#include "GAME_STATE_H.h"
+#include "METRICS_H.h"
+
+using namespace std;
+
+// --- TRANSPOSITION TABLE ---
+// Keyed by a 64-bit state key: GameEngine::stateHash() for sessions, the
+// packed SolverState for the solver. Split into shards with their own lock
+// so solver and simulation threads rarely wait on each other. Keys are mixed
+// before picking a shard, so packed keys with empty high bits still spread.
+template <class V>
+struct TranspositionTable {
+    static const int SHARDS = 64;
+
+    struct Shard {
+        mutable mutex lock;
+        unordered_map<uint64_t, V> entries;
+    };
+    Shard shards[SHARDS];
+
+    Shard& shardFor(uint64_t key) { return shards[zobristMix(key) >> 58]; }
+    const Shard& shardFor(uint64_t key) const { return shards[zobristMix(key) >> 58]; }
+
+    bool find(uint64_t key, V& out) const {
+        const Shard& s = shardFor(key);
+        lock_guard<mutex> guard(s.lock);
+        auto it = s.entries.find(key);
+        if (it == s.entries.end()) return false;
+        out = it->second;
+        return true;
+    }
+
+    void store(uint64_t key, const V& value) {
+        Shard& s = shardFor(key);
+        lock_guard<mutex> guard(s.lock);
+        s.entries[key] = value;
+    }
+
+    // Returns the existing entry, or builds one with make() and keeps it.
+    // make() runs under the shard lock, so two threads never build the same entry.
+    template <class F>
+    V findOrAdd(uint64_t key, F make) {
+        Shard& s = shardFor(key);
+        lock_guard<mutex> guard(s.lock);
+        auto it = s.entries.find(key);
+        if (it != s.entries.end()) return it->second;
+        return s.entries.emplace(key, make()).first->second;
+    }
+
+    // Runs f on the key's shard (its unordered_map) under the shard lock,
+    // for updates the calls above cannot express.
+    template <class F>
+    auto withShard(uint64_t key, F f) {
+        Shard& s = shardFor(key);
+        lock_guard<mutex> guard(s.lock);
+        return f(s.entries);
+    }
+
+    size_t size() const {
+        size_t n = 0;
+        for (const Shard& s : shards) {
+            lock_guard<mutex> guard(s.lock);
+            n += s.entries.size();
+        }
+        return n;
+    }
+
+    void clear() {
+        for (Shard& s : shards) {
+            lock_guard<mutex> guard(s.lock);
+            s.entries.clear();
+        }
+    }
+};
+
+// --- SHARED SNAPSHOTS ---
+// One immutable copy per distinct game state, however many sessions,
+// undo points or rollouts arrive at it. The pack is the session's own
+// persistent list (GAME_STATE_H.h), so a snapshot shares it instead of
+// copying it; pending events are copied once, and only if there are any.
+struct Snapshot {
+    uint64_t hash;
+    Wolf wolf;
+    int nodeId;
+    shared_ptr<const Item> items;                 // pack order
+    shared_ptr<const vector<GameEvent>> events;   // pending, in eventBefore order; null if none
+    bool eventActive;
+    GameEvent activeEvent;                        // only meaningful while eventActive
+};
+
+inline bool sameState(const Snapshot& a, const Snapshot& b) {
+    if (a.hash != b.hash || a.nodeId != b.nodeId || a.eventActive != b.eventActive) return false;
+    if (a.wolf.health != b.wolf.health || a.wolf.hunger != b.wolf.hunger || a.wolf.energy != b.wolf.energy) return false;
+    if (a.eventActive && !sameEvent(a.activeEvent, b.activeEvent)) return false;
+    if (!samePack(a.items.get(), b.items.get())) return false;
+    size_t na = a.events ? a.events->size() : 0, nb = b.events ? b.events->size() : 0;
+    if (na != nb) return false;
+    for (size_t i = 0; i < na; i++)
+        if (!sameEvent((*a.events)[i], (*b.events)[i])) return false;
+    return true;
+}
+
+// Interned snapshots are counted, not kept: the table holds weak entries
+// and the last owner to let go removes its entry. On a hash hit the full
+// state is compared; a colliding state gets a private copy that is not
+// interned. The store must outlive every snapshot it hands out.
+struct SnapshotStore {
+    TranspositionTable<weak_ptr<const Snapshot>> table;
+    atomic<long long> collisions{0};
+
+    shared_ptr<const Snapshot> intern(Snapshot s) {
+        uint64_t key = s.hash;
+        shared_ptr<const Snapshot> known;   // dropped after the lock: it may be the last owner
+        return table.withShard(key, [&](unordered_map<uint64_t, weak_ptr<const Snapshot>>& entries) {
+            weak_ptr<const Snapshot>& entry = entries[key];
+            if ((known = entry.lock())) {
+                if (sameState(*known, s)) return known;
+                collisions++;
+                metricsCount(C_ALLOCS);
+                return shared_ptr<const Snapshot>(make_shared<const Snapshot>(move(s)));
+            }
+            metricsCount(C_ALLOCS);
+            shared_ptr<const Snapshot> fresh(new Snapshot(move(s)), Release{this});
+            entry = fresh;
+            return fresh;
+        });
+    }
+
+    // Snapshots alive right now.
+    size_t size() const { return table.size(); }
+
+private:
+    struct Release {
+        SnapshotStore* store;
+        void operator()(const Snapshot* s) const {
+            store->table.withShard(s->hash, [&](unordered_map<uint64_t, weak_ptr<const Snapshot>>& entries) {
+                auto it = entries.find(s->hash);
+                if (it != entries.end() && it->second.expired()) entries.erase(it);   // not if a newer one took the key
+                return 0;
+            });
+            delete s;
+        }
+    };
+};
+
+// The store sessions intern into unless told otherwise, so undo points,
+// forks and other sessions that reach the same state share it.
+inline SnapshotStore& sharedSnapshots() {
+    static SnapshotStore store;
+    return store;
+}
+
+#endif
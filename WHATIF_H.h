@@ -0,0 +1,136 @@
+#ifndef WHATIF_H
+#define WHATIF_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include "GAME_ENGINE_H.h"
+#include "TRANSPOSITION_H.h"
+#include "THREAD_POOL_H.h"
+#include "SOLVER_H.h"
+
+using namespace std;
+
+// --- FORKS ---
+// A fork is the session's state interned in its SnapshotStore, plus what is
+// needed to play on from it. Forking is a hash lookup when the state is
+// already interned (the session's undo points intern into the same store)
+// and one snapshot otherwise, which shares the session's pack. Forks of a
+// fork share that snapshot. Nothing is written until a rollout restores the
+// fork into its own scratch engine, and that takes the pack by pointer too.
+struct EngineFork {
+    shared_ptr<const Snapshot> state;
+    const Story* story = nullptr;
+    const StoryNode* at = nullptr;
+    const WorldSim* world = nullptr;
+};
+
+inline EngineFork forkEngine(const GameEngine& g) {
+    return {g.snapshots->intern(g.capture()), g.story, g.current, g.world};
+}
+
+// Turns a scratch engine into a private copy of the fork. A rollout never
+// undoes, so its turns record nothing in the history or the shared store.
+inline void materialize(GameEngine& g, const EngineFork& f, uint64_t seed) {
+    g.undoable = false;
+    g.history = History();
+    g.story = f.story;
+    g.current = f.at;
+    g.world = f.world;
+    g.restore(*f.state);
+    g.seed(seed);
+}
+
+// --- ROLLOUTS ---
+// Plays one future to its end: the given first choice, then a plain
+// survival policy (eat when hungry, heal when hurt, otherwise a coin flip).
+// A turn that only clears an event is played in place, so the first choice
+// is always the first move. Same survival rules as the solver.
+inline bool rollout(GameEngine& g, int firstChoice, int maxTurns = 64) {
+    bool moved = false;
+    for (int t = 0; t < maxTurns; t++) {
+        if (isDeath(g.player.health, g.player.hunger, g.player.energy)) return false;
+        if (g.current->isEnding) return isSurvivalEnding(g.current->description);
+        if (!g.current->hasChoices()) return false;
+        if (g.eventActive) { g.makeChoice(0); continue; }
+        int choice = firstChoice;
+        if (moved) {
+            for (const Item* i = g.inventoryHead.get(); i; i = i->next.get()) {
+                if ((i->onUse.delta[STAT_HUNGER] < 0 && g.player.hunger >= 60) ||
+                    (i->onUse.delta[STAT_HEALTH] > 0 && g.player.health <= 50)) {
+                    g.useItem(i->name);
+                    break;
+                }
+            }
+            choice = 1 + g.rollPercent() % 2;
+        }
+        moved = true;
+        g.makeChoice(choice);
+    }
+    return false;
+}
+
+// --- WHAT-IF PREVIEWS ---
+// Survival odds of choice A vs B from the scene the player is reading,
+// estimated in the background and readable at any time. cancel() stops it
+// within one rollout per worker.
+struct WhatIf {
+    atomic<long long> runs[2];
+    atomic<long long> survived[2];
+    atomic<int> tasksLeft{0};
+    atomic<bool> cancelled{false};
+
+    WhatIf() {
+        for (int c = 0; c < 2; c++) { runs[c] = 0; survived[c] = 0; }
+    }
+
+    double odds(int choice) const {
+        long long n = runs[choice - 1];
+        return n ? (double)survived[choice - 1] / n : 0;
+    }
+    long long samples(int choice) const { return runs[choice - 1]; }
+    bool done() const { return tasksLeft == 0; }
+    void cancel() { cancelled = true; }
+};
+
+struct WhatIfEvaluator {
+    static const int BATCH = 32;   // rollouts per task
+
+    ThreadPool& pool;
+
+    explicit WhatIfEvaluator(ThreadPool& p) : pool(p) {}
+
+    // Starts rollouts per choice from the session's current state.
+    shared_ptr<WhatIf> begin(const GameEngine& g, int rollouts = 4096) {
+        auto preview = make_shared<WhatIf>();
+        if (!g.current || g.current->isEnding) return preview;
+        EngineFork fork = forkEngine(g);
+        int batches = (rollouts + BATCH - 1) / BATCH;
+        preview->tasksLeft = 2 * batches;
+        for (int b = 0; b < batches; b++) {   // interleaved, so both choices fill in together
+            for (int c = 1; c <= 2; c++) {
+                pool.submit([preview, fork, c, b] {
+                    static thread_local GameEngine scratch;
+                    for (int i = 0; i < BATCH && !preview->cancelled.load(memory_order_relaxed); i++) {
+                        materialize(scratch, fork, zobristMix(fork.state->hash ^ ((uint64_t)c << 40) ^ (uint64_t)(b * BATCH + i)));
+                        bool lived = rollout(scratch, c);
+                        preview->runs[c - 1]++;
+                        if (lived) preview->survived[c - 1]++;
+                    }
+                    preview->tasksLeft--;
+                });
+            }
+        }
+        return preview;
+    }
+
+    // The player's move: drop the old preview, play it, preview the next scene.
+    void choose(GameEngine& g, shared_ptr<WhatIf>& preview, int choice, int rollouts = 4096) {
+        if (preview) preview->cancel();
+        g.makeChoice(choice);
+        preview = begin(g, rollouts);
+    }
+};
+
+#endif
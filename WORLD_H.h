@@ -0,0 +1,147 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+// --- SHARED WORLD ---
+// Weather and wildlife shared by every session. The simulation ticks on its
+// own thread; sessions only read it, once per turn.
+enum Season { SPRING, SUMMER, AUTUMN, WINTER };
+
+struct WorldState {
+    long long tick = 0;
+    int season = WINTER;
+    int stormFront = 50;       // 0 calm .. 100 blizzard
+    int preyDensity = 60;      // 0 none .. 100 plenty
+    int hunterActivity = 30;   // 0 none .. 100 everywhere
+
+    // Per-turn odds, in percent, for the events the world drives.
+    int stormChance() const { return 5 + stormFront / 2; }
+    int hunterChance() const { return hunterActivity / 5; }
+    int preyChance() const { return preyDensity / 5; }
+    // Entering an ending: odds the last stretch goes wrong (LAST_STRETCH),
+    // which a weakened wolf does not survive. Storms and hunters raise them,
+    // plentiful prey lowers them.
+    int endingRiskChance() const { return clamp(stormFront / 3 + hunterActivity / 3 - preyDensity / 5, 0, 60); }
+};
+
+const int TICKS_PER_SEASON = 600;
+
+// --- PUBLISHING ---
+// Three slots. The simulation always writes the slot after the published
+// one, then publishes it with one atomic store, so a reader and the writer
+// only meet if the reader stalls through two whole ticks. Each slot has a
+// sequence number (odd while being written); a reader copies the slot and
+// retries if the number changed or was odd. Readers never block the
+// simulation and never take a lock.
+struct WorldSlot {
+    atomic<uint32_t> seq{0};
+    atomic<long long> tick{0};
+    atomic<int> season{0}, stormFront{0}, preyDensity{0}, hunterActivity{0};
+};
+
+struct WorldSim {
+    explicit WorldSim(uint64_t seed = 1) : rng(seed ? seed : 1) { publish(WorldState()); }
+    ~WorldSim() { stop(); }
+
+    WorldSim(const WorldSim&) = delete;
+    WorldSim& operator=(const WorldSim&) = delete;
+
+    // Any thread: a consistent copy of the latest tick.
+    WorldState read() const {
+        while (true) {
+            const WorldSlot& s = slots[published.load(memory_order_acquire)];
+            uint32_t before = s.seq.load(memory_order_acquire);
+            WorldState w;
+            w.tick = s.tick.load(memory_order_relaxed);
+            w.season = s.season.load(memory_order_relaxed);
+            w.stormFront = s.stormFront.load(memory_order_relaxed);
+            w.preyDensity = s.preyDensity.load(memory_order_relaxed);
+            w.hunterActivity = s.hunterActivity.load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            if (!(before & 1) && s.seq.load(memory_order_relaxed) == before) return w;
+        }
+    }
+
+    // One tick, on the caller's thread (headless runs, tests).
+    void step() {
+        state = evolve(state);
+        publish(state);
+    }
+
+    void start(chrono::milliseconds period) {
+        if (worker.joinable()) return;
+        stopping = false;
+        worker = thread([this, period] {
+            auto next = chrono::steady_clock::now();
+            unique_lock<mutex> lk(sleepLock);
+            while (!stopping) {
+                step();
+                next += period;
+                wake.wait_until(lk, next, [this] { return stopping; });
+            }
+        });
+    }
+
+    void stop() {
+        {
+            lock_guard<mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+private:
+    WorldSlot slots[3];
+    atomic<int> published{0};
+    WorldState state;   // simulation thread only
+    uint64_t rng;
+    bool stopping = false;
+    mutex sleepLock;
+    condition_variable wake;
+    thread worker;
+
+    int noise(int spread) {   // xorshift64, -spread..spread
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        return (int)(rng % (uint64_t)(2 * spread + 1)) - spread;
+    }
+
+    WorldState evolve(WorldState w) {
+        static const int stormTarget[4] = {30, 10, 40, 80};
+        static const int hunterTarget[4] = {20, 30, 70, 40};
+        static const int preyGrowth[4] = {4, 3, 1, 0};
+        w.tick++;
+        w.season = (int)((w.tick / TICKS_PER_SEASON + WINTER) % 4);
+        w.stormFront = clamp(w.stormFront + (stormTarget[w.season] - w.stormFront) / 8 + noise(10), 0, 100);
+        w.hunterActivity = clamp(w.hunterActivity + (hunterTarget[w.season] - w.hunterActivity) / 16 + noise(3), 0, 100);
+        int born = w.preyDensity * (100 - w.preyDensity) * preyGrowth[w.season] / 2000;
+        w.preyDensity = clamp(w.preyDensity + born - w.hunterActivity / 40 + noise(2), 1, 100);
+        return w;
+    }
+
+    void publish(const WorldState& w) {
+        int next = (published.load(memory_order_relaxed) + 1) % 3;
+        WorldSlot& s = slots[next];
+        uint32_t seq = s.seq.load(memory_order_relaxed);
+        s.seq.store(seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        s.tick.store(w.tick, memory_order_relaxed);
+        s.season.store(w.season, memory_order_relaxed);
+        s.stormFront.store(w.stormFront, memory_order_relaxed);
+        s.preyDensity.store(w.preyDensity, memory_order_relaxed);
+        s.hunterActivity.store(w.hunterActivity, memory_order_relaxed);
+        s.seq.store(seq + 2, memory_order_release);
+        published.store(next, memory_order_release);
+    }
+};
+
+#endif
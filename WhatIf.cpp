@@ -0,0 +1,83 @@
+// Plays a session and shows the survival odds of each choice, estimated
+// in the background from a fork of the live state while the scene is read.
+// Build: g++ -O2 -std=c++17 -pthread WhatIf.cpp -o whatif
+// Run:   ./whatif [threads] [rollouts] [readMs]
+//        ./whatif --check   checks rollouts from a fork with an event pending
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "GAME_ENGINE_H.h"
+#include "WHATIF_H.h"
+
+using namespace std;
+
+// A fork taken while an event is up: each rollout must clear it and then
+// make its own first move, without recording undo points.
+static int check() {
+    GameEngine game;
+    game.init();
+    game.seed(1);
+    for (int c : {1, 1, 2, 1}) {   // to scene 12: A goes on to 15, B to 16
+        while (game.eventActive) game.makeChoice(0);
+        game.makeChoice(c);
+    }
+    while (game.eventActive) game.makeChoice(0);
+    game.eventQueue.push(SNOWSTORM);
+    game.eventHash += GameEngine::eventKey(SNOWSTORM);
+    game.makeChoice(0);   // the storm hits while the wolf waits in 12
+
+    int failures = 0;
+    auto expect = [&](bool ok, const string& what) {
+        cout << (ok ? "ok    " : "FAIL  ") << what << endl;
+        if (!ok) failures++;
+    };
+    expect(game.current->id == 12 && game.eventActive, "forked in scene 12 with an event up");
+
+    EngineFork fork = forkEngine(game);
+    GameEngine scratch;
+    size_t stored = sharedSnapshots().size();
+    int reached[2];
+    for (int c = 1; c <= 2; c++) {
+        materialize(scratch, fork, 1);
+        rollout(scratch, c, 2);
+        reached[c - 1] = scratch.current->id;
+    }
+    expect(reached[0] == 15 && reached[1] == 16, "A and B each make the first move: 12 -> " +
+           to_string(reached[0]) + " / " + to_string(reached[1]));
+    expect(scratch.history.nodes.empty() && sharedSnapshots().size() == stored, "rollouts record no undo points");
+
+    cout << (failures ? to_string(failures) + " failed" : string("all checks passed")) << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--check") == 0) return check();
+    int threads = argc > 1 ? atoi(argv[1]) : (int)thread::hardware_concurrency();
+    int rollouts = argc > 2 ? atoi(argv[2]) : 20000;
+    int readMs = argc > 3 ? atoi(argv[3]) : 50;
+
+    GameEngine game;
+    game.init();
+    game.seed(7);
+    ThreadPool pool(threads);
+    WhatIfEvaluator eval(pool);
+
+    shared_ptr<WhatIf> preview = eval.begin(game, rollouts);
+    while (!game.current->isEnding && !isDeath(game.player.health, game.player.hunger, game.player.energy)) {
+        this_thread::sleep_for(chrono::milliseconds(readMs));   // the player reads the scene
+        const StoryNode& s = *game.current;
+        printf("scene %2d  A %-16.*s %5.1f%% (%lld)   B %-16.*s %5.1f%% (%lld)%s\n", s.id,
+               (int)s.choiceA.size(), s.choiceA.data(), 100 * preview->odds(1), preview->samples(1),
+               (int)s.choiceB.size(), s.choiceB.data(), 100 * preview->odds(2), preview->samples(2),
+               preview->done() ? "" : "  [still running]");
+        int pick = preview->odds(1) >= preview->odds(2) ? 1 : 2;
+        eval.choose(game, preview, pick, rollouts);
+    }
+    preview->cancel();
+    pool.wait();
+    cout << "ending: " << game.current->description << "\n";
+    return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+// --- ZOBRIST KEYS ---
+// Keys are computed, not tabled, so any stat value or item name has one
+// without fixed bounds. Single-valued fields (scene, stats) are XORed in and
+// out; multisets (items, pending events) are summed so duplicates never
+// cancel. Every update is O(1).
+enum ZobristField {
+    Z_NODE = 1,
+    Z_HEALTH,
+    Z_HUNGER,
+    Z_ENERGY,
+    Z_ITEM,
+    Z_EVENT,
+    Z_ACTIVE_EVENT,
+    Z_BAG,
+};
+
+inline uint64_t zobristMix(uint64_t z) {   // splitmix64 finalizer
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t zobristKey(ZobristField field, int64_t value) {
+    return zobristMix(((uint64_t)field << 56) ^ (uint64_t)value);
+}
+
+inline uint64_t zobristString(const string& s) {   // FNV-1a
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (unsigned char c : s) { h ^= c; h *= 0x100000001B3ULL; }
+    return h;
+}
+
+inline uint64_t zobristThing(ZobristField field, const string& a, const string& b, int n) {
+    return zobristMix(zobristKey(field, n) ^ zobristString(a) ^ zobristMix(zobristString(b)));
+}
+
+#endif